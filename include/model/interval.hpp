@@ -0,0 +1,109 @@
+#ifndef __UMO_INTERVAL_HPP__
+#define __UMO_INTERVAL_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace umoi {
+/*
+ * Closed interval [lb, ub] used for bound computations.
+ * Infinite bounds are represented by infinite values; an interval with
+ * lb > ub is empty, which denotes an infeasibility.
+ */
+struct Interval {
+    double lb;
+    double ub;
+
+    // Default constructor: unbounded interval
+    Interval()
+        : lb(-std::numeric_limits<double>::infinity()),
+          ub(std::numeric_limits<double>::infinity()) {}
+    Interval(double val) : lb(val), ub(val) {}
+    Interval(double lb, double ub) : lb(lb), ub(ub) {}
+
+    static Interval full() { return Interval(); }
+    static Interval boolean() { return Interval(0.0, 1.0); }
+    static Interval emptySet() {
+        return Interval(std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity());
+    }
+
+    bool empty() const { return !(lb <= ub); }
+    bool isPoint() const { return lb == ub; }
+    bool isFinite() const { return std::isfinite(lb) && std::isfinite(ub); }
+    bool contains(double val) const { return lb <= val && val <= ub; }
+    bool contains(const Interval &o) const { return lb <= o.lb && o.ub <= ub; }
+    // Width of the interval (may be infinite)
+    double width() const { return ub - lb; }
+
+    Interval intersect(const Interval &o) const {
+        return Interval(std::max(lb, o.lb), std::min(ub, o.ub));
+    }
+    Interval unite(const Interval &o) const {
+        if (empty())
+            return o;
+        if (o.empty())
+            return *this;
+        return Interval(std::min(lb, o.lb), std::max(ub, o.ub));
+    }
+    // Restrict to the integers within the interval
+    Interval roundInward() const {
+        return Interval(std::ceil(lb - intTol), std::floor(ub + intTol));
+    }
+
+    Interval operator-() const { return Interval(-ub, -lb); }
+    Interval operator+(const Interval &o) const {
+        return Interval(lb + o.lb, ub + o.ub);
+    }
+    Interval operator-(const Interval &o) const {
+        return Interval(lb - o.ub, ub - o.lb);
+    }
+    Interval operator*(const Interval &o) const {
+        double p1 = mul(lb, o.lb);
+        double p2 = mul(lb, o.ub);
+        double p3 = mul(ub, o.lb);
+        double p4 = mul(ub, o.ub);
+        return Interval(std::min(std::min(p1, p2), std::min(p3, p4)),
+                        std::max(std::max(p1, p2), std::max(p3, p4)));
+    }
+    Interval operator/(const Interval &o) const { return *this * o.inv(); }
+    bool operator==(const Interval &o) const {
+        return lb == o.lb && ub == o.ub;
+    }
+    bool operator!=(const Interval &o) const { return !(*this == o); }
+
+    Interval inv() const {
+        if (lb > 0.0 || ub < 0.0)
+            return Interval(1.0 / ub, 1.0 / lb);
+        if (lb == 0.0 && ub > 0.0)
+            return Interval(1.0 / ub, std::numeric_limits<double>::infinity());
+        if (ub == 0.0 && lb < 0.0)
+            return Interval(-std::numeric_limits<double>::infinity(), 1.0 / lb);
+        return Interval();
+    }
+    Interval abs() const {
+        if (lb >= 0.0)
+            return *this;
+        if (ub <= 0.0)
+            return -*this;
+        return Interval(0.0, std::max(-lb, ub));
+    }
+    Interval square() const {
+        Interval a = abs();
+        return Interval(a.lb * a.lb, a.ub * a.ub);
+    }
+
+    // Multiplication with the convention 0 * inf = 0
+    static double mul(double a, double b) {
+        if (a == 0.0 || b == 0.0)
+            return 0.0;
+        return a * b;
+    }
+
+    // Tolerance used when rounding bounds of integer expressions
+    static constexpr double intTol = 1.0e-9;
+};
+} // namespace umoi
+
+#endif
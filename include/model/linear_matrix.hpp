@@ -0,0 +1,137 @@
+#ifndef __UMO_LINEAR_MATRIX_HPP__
+#define __UMO_LINEAR_MATRIX_HPP__
+
+#include "model/model.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace umoi {
+/*
+ * Sparse matrix form lb <= A x <= ub of a linearized model, for the file
+ * writers and the in-process backends.
+ *
+ * Columns are the decisions, in the order of the expressions. Rows are the
+ * LINEARCOMP constraints and the rows enforced by an indicator constraint,
+ * in the order of the expressions. The coefficients are stored both in
+ * compressed row (CSR) and compressed column (CSC) form, without duplicate
+ * entries. The matrix is built in O(nnz) from a model accepted by
+ * ToLinear; products of two variables kept for quadratic solvers are
+ * stored apart from the linear coefficients.
+ */
+class LinearMatrix {
+  public:
+    static constexpr std::int32_t InvalidIndex = -1;
+
+    // Product coef * x[col1] * x[col2]
+    struct QuadraticTerm {
+        std::uint32_t col1;
+        std::uint32_t col2;
+        double coef;
+    };
+
+    struct Objective {
+        // Expression of the objective
+        ExpressionId expr;
+        bool maximize;
+        // False if the objective is not an affine or quadratic function; its
+        // coefficients are then empty
+        bool linear;
+        // Dense coefficients, indexed by column
+        std::vector<double> coefs;
+        std::vector<QuadraticTerm> quadratic;
+        double offset;
+    };
+
+  public:
+    explicit LinearMatrix(const Model &m);
+
+    std::uint32_t nbRows() const { return rowExpr_.size(); }
+    std::uint32_t nbColumns() const { return colExpr_.size(); }
+    std::uint32_t nbNonZeros() const { return rowIndex_.size(); }
+
+    // Columns
+    std::uint32_t colExpr(std::uint32_t col) const { return colExpr_[col]; }
+    // Column of a decision, or InvalidIndex
+    std::int32_t exprToCol(std::uint32_t expr) const {
+        return exprToCol_[expr];
+    }
+    umo_type colType(std::uint32_t col) const { return colType_[col]; }
+    double colLb(std::uint32_t col) const { return colLb_[col]; }
+    double colUb(std::uint32_t col) const { return colUb_[col]; }
+
+    // Rows
+    std::uint32_t rowExpr(std::uint32_t row) const { return rowExpr_[row]; }
+    double rowLb(std::uint32_t row) const { return rowLb_[row]; }
+    double rowUb(std::uint32_t row) const { return rowUb_[row]; }
+    // Column of the boolean enforcing the row, or InvalidIndex
+    std::int32_t rowIndicator(std::uint32_t row) const {
+        return rowIndicator_[row];
+    }
+    // Value of the boolean for which the row is enforced
+    bool rowIndicatorValue(std::uint32_t row) const {
+        return rowIndicatorValue_[row];
+    }
+
+    // Compressed row form: entries of row r are in [rowStart[r],
+    // rowStart[r+1])
+    const std::vector<std::uint32_t> &rowStart() const { return rowStart_; }
+    const std::vector<std::uint32_t> &rowIndex() const { return rowIndex_; }
+    const std::vector<double> &rowValue() const { return rowValue_; }
+
+    // Compressed column form: entries of column c are in [colStart[c],
+    // colStart[c+1])
+    const std::vector<std::uint32_t> &colStart() const { return colStart_; }
+    const std::vector<std::uint32_t> &colIndex() const { return colIndex_; }
+    const std::vector<double> &colValue() const { return colValue_; }
+
+    // Quadratic terms of row r are in [quadStart[r], quadStart[r+1])
+    const std::vector<std::uint32_t> &quadStart() const { return quadStart_; }
+    const std::vector<QuadraticTerm> &quadTerms() const { return quadTerms_; }
+
+    const std::vector<Objective> &objectives() const { return objectives_; }
+
+  private:
+    void initColumns();
+    void initRows();
+    void initColumnForm();
+    void initObjectives();
+
+    // Add the term coef * id of a linear expression
+    void addTerm(ExpressionId id, double coef, std::vector<double> &dense,
+                 std::vector<std::uint32_t> &cols,
+                 std::vector<QuadraticTerm> &quadratic, double &constant) const;
+    // Whether the expression is a product of two variables and constants
+    bool isQuadratic(ExpressionId id) const;
+
+  private:
+    const Model &m_;
+
+    std::vector<std::uint32_t> colExpr_;
+    std::vector<std::int32_t> exprToCol_;
+    std::vector<umo_type> colType_;
+    std::vector<double> colLb_;
+    std::vector<double> colUb_;
+
+    std::vector<std::uint32_t> rowExpr_;
+    std::vector<double> rowLb_;
+    std::vector<double> rowUb_;
+    std::vector<std::int32_t> rowIndicator_;
+    std::vector<char> rowIndicatorValue_;
+
+    std::vector<std::uint32_t> rowStart_;
+    std::vector<std::uint32_t> rowIndex_;
+    std::vector<double> rowValue_;
+
+    std::vector<std::uint32_t> colStart_;
+    std::vector<std::uint32_t> colIndex_;
+    std::vector<double> colValue_;
+
+    std::vector<std::uint32_t> quadStart_;
+    std::vector<QuadraticTerm> quadTerms_;
+
+    std::vector<Objective> objectives_;
+};
+} // namespace umoi
+
+#endif
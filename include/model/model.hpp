@@ -4,14 +4,20 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "api/umo_enums.h"
 #include "model/expression_id.hpp"
+#include "model/interval.hpp"
 
 namespace umoi {
+namespace presolve {
+struct IncrementalState;
+}
 class PresolvedModel;
 class Model {
   public:
@@ -32,16 +38,45 @@ class Model {
 
     double getFloatValue(ExpressionId expr);
     void setFloatValue(ExpressionId expr, double value);
+    // Bulk versions: values are computed once, and all values are validated
+    // before any decision is modified
+    std::vector<double> getFloatValues(const std::vector<ExpressionId> &exprs);
+    void setFloatValues(const std::vector<ExpressionId> &exprs,
+                        const std::vector<double> &values);
     umo_solution_status getStatus();
     void setStatus(umo_solution_status status);
 
+    // Bounds of the expressions, propagated from the decision bounds
+    Interval getBounds(ExpressionId expr);
+    void computeBounds();
+
     void solve();
     void check() const;
 
+    // Merkle hash of the expression DAG, its constraints and objectives;
+    // identical models have the same hash, whatever their values
+    std::uint64_t hash() const;
+    // Whether this model is obtained from the other by appending expressions
+    // and constraints, with the same objectives
+    bool extends(const Model &other) const;
+
     double getFloatParameter(const std::string &param) const;
     void setFloatParameter(const std::string &param, double value);
     const std::string &getStringParameter(const std::string &param) const;
     void setStringParameter(const std::string &param, const std::string &value);
+    // Parameters and incremental state of the other model
+    void copyParameters(const Model &model);
+
+    // Transformation results kept between the solves of this model, shared
+    // with its presolved copies
+    const std::shared_ptr<presolve::IncrementalState> &
+    incrementalState() const {
+        return incrementalState_;
+    }
+    void setIncrementalState(
+        const std::shared_ptr<presolve::IncrementalState> &state) {
+        incrementalState_ = state;
+    }
 
     std::uint32_t nbExpressions() const {
         return (std::uint32_t)expressions_.size();
@@ -68,6 +103,7 @@ class Model {
         return objectives_[id];
     }
     const double &value(std::uint32_t id) const { return values_[id]; }
+    const Interval &bounds(std::uint32_t id) const { return bounds_[id]; }
 
     bool isConstant(std::uint32_t id) const;
     bool isLeaf(std::uint32_t id) const;
@@ -80,6 +116,7 @@ class Model {
     umo_type getExpressionIdType(ExpressionId expr) const;
     umo_operator getExpressionIdOp(ExpressionId expr) const;
     double getExpressionIdValue(ExpressionId expr) const;
+    Interval getExpressionIdBounds(ExpressionId expr) const;
     std::vector<ExpressionId> getExpressionIdOperands(ExpressionId expr) const;
 
     void writeUmo(std::ostream &) const;
@@ -106,6 +143,8 @@ class Model {
     std::vector<umo_operator> getOperandOps(const ExpressionData &expr) const;
 
     void compute();
+    // Check that a decision can be set and return the value of its variable
+    double checkDecisionValue(ExpressionId expr, double value) const;
     void computeStatus();
 
     void initDefaultParameters();
@@ -127,8 +166,13 @@ class Model {
     bool computed_;
     bool statusComputed_;
 
+    // Bounds of the expressions (cached)
+    std::vector<Interval> bounds_;
+    bool boundsComputed_;
+
     std::unordered_map<std::string, std::string> stringParams_;
     std::unordered_map<std::string, double> floatParams_;
+    std::shared_ptr<presolve::IncrementalState> incrementalState_;
 };
 
 struct Model::ExpressionData {
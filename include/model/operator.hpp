@@ -6,6 +6,7 @@
 #include <string>
 
 #include "api/umo_enums.h"
+#include "model/interval.hpp"
 
 namespace umoi {
 
@@ -35,6 +36,9 @@ class Operator {
     // Perform the computation
     virtual double compute(int nbOperands, double *operands) const = 0;
 
+    // Compute the bounds of the result from the bounds of the operands
+    virtual Interval computeBounds(int nbOperands, Interval *operands) const;
+
     // Is a leaf of the expression graph (constant/decision)
     virtual bool isLeaf() const { return false; }
     // Is a decision variable
@@ -55,7 +59,6 @@ class Operator {
     virtual bool isNary() const { return false; }
 
     // TODO:
-    // Bound computation
     // Differenciation
     // Direction information (relies on bounds)
     // Convexity information (relies on bounds)
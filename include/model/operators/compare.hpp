@@ -24,6 +24,11 @@ class Eq final : public CompareOp {
         return compareEq(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsEq(operands[0], operands[1]);
+    }
+
     static Eq instance;
 };
 
@@ -38,6 +43,11 @@ class Neq final : public CompareOp {
         return compareNeq(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsNeq(operands[0], operands[1]);
+    }
+
     static Neq instance;
 };
 
@@ -52,6 +62,11 @@ class Leq final : public CompareOp {
         return compareLeq(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsLeq(operands[0], operands[1]);
+    }
+
     static Leq instance;
 };
 
@@ -66,6 +81,11 @@ class Geq final : public CompareOp {
         return compareGeq(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsLeq(operands[1], operands[0]);
+    }
+
     static Geq instance;
 };
 
@@ -80,6 +100,11 @@ class Lt final : public CompareOp {
         return compareLt(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsLt(operands[0], operands[1]);
+    }
+
     static Lt instance;
 };
 
@@ -94,6 +119,11 @@ class Gt final : public CompareOp {
         return compareGt(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert(nbOperands == 2);
+        return boundsLt(operands[1], operands[0]);
+    }
+
     static Gt instance;
 };
 
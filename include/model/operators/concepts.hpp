@@ -170,6 +170,35 @@ class ComparisonOp : public OutBoolOp {
         return op1 >= op2 || compareEq(op1, op2);
     }
 
+    Interval boundsEq(const Interval &op1, const Interval &op2) const {
+        if (op1.isPoint() && op2.isPoint() && compareEq(op1.lb, op2.lb))
+            return Interval(1.0);
+        if (compareLt(op1.ub, op2.lb) || compareGt(op1.lb, op2.ub))
+            return Interval(0.0);
+        return Interval::boolean();
+    }
+
+    Interval boundsNeq(const Interval &op1, const Interval &op2) const {
+        Interval eq = boundsEq(op1, op2);
+        return Interval(1.0 - eq.ub, 1.0 - eq.lb);
+    }
+
+    Interval boundsLeq(const Interval &op1, const Interval &op2) const {
+        if (compareLeq(op1.ub, op2.lb))
+            return Interval(1.0);
+        if (!compareLeq(op1.lb, op2.ub))
+            return Interval(0.0);
+        return Interval::boolean();
+    }
+
+    Interval boundsLt(const Interval &op1, const Interval &op2) const {
+        if (compareLt(op1.ub, op2.lb))
+            return Interval(1.0);
+        if (!compareLt(op1.lb, op2.ub))
+            return Interval(0.0);
+        return Interval::boolean();
+    }
+
     bool isComparison() const final override { return true; }
 
     // TODO: make tolerance a runtime parameter
@@ -184,6 +213,24 @@ class AssociativeOp : virtual public Operator {
 class IdempotentOp : virtual public Operator {
     bool isIdempotent() const final override { return true; }
 };
+
+// Bounds of a nondecreasing function restricted to its domain
+inline Interval increasingBounds(const Interval &x, const Interval &domain,
+                                 double (*f)(double)) {
+    Interval r = x.intersect(domain);
+    if (r.empty())
+        return Interval();
+    return Interval(f(r.lb), f(r.ub));
+}
+
+// Bounds of a nonincreasing function restricted to its domain
+inline Interval decreasingBounds(const Interval &x, const Interval &domain,
+                                 double (*f)(double)) {
+    Interval r = x.intersect(domain);
+    if (r.empty())
+        return Interval();
+    return Interval(f(r.ub), f(r.lb));
+}
 }
 }
 
@@ -37,6 +37,10 @@ class DecBool final : public NoaryOp, public DecisionOp, public OutBoolOp {
         throw std::runtime_error("Computing a decision operator (bool) is not possible.");
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return Interval::boolean();
+    }
+
     static DecBool instance;
 };
 
@@ -50,6 +54,10 @@ class DecInt final : public BinaryOp, public DecisionOp, public OutIntOp, public
         throw std::runtime_error("Computing a decision operator (int) is not possible.");
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return Interval(operands[0].lb, operands[1].ub).roundInward();
+    }
+
     static DecInt instance;
 };
 
@@ -63,6 +71,10 @@ class DecFloat final : public BinaryOp, public DecisionOp, public OutFloatOp, pu
         throw std::runtime_error("Computing a decision operator (float) is not possible.");
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return Interval(operands[0].lb, operands[1].ub);
+    }
+
     static DecFloat instance;
 };
 
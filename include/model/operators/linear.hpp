@@ -33,6 +33,14 @@ class Linear final : public OutFloatOp, public InFloatOp {
         return ret;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval ret(0.0);
+        for (int i = 0; 2*i < nbOperands; ++i) {
+            ret = ret + operands[2*i] * operands[2*i+1];
+        }
+        return ret;
+    }
+
     static Linear instance;
 };
 
@@ -62,6 +70,17 @@ class LinearComp final : public ComparisonOp, public InFloatOp {
         return compareLeq(operands[0], val) && compareLeq(val, operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval val(0.0);
+        for (int i = 1; 2*i < nbOperands; ++i) {
+            val = val + operands[2*i] * operands[2*i+1];
+        }
+        Interval lower = boundsLeq(operands[0], val);
+        Interval upper = boundsLeq(val, operands[1]);
+        return Interval(std::min(lower.lb, upper.lb),
+                        std::min(lower.ub, upper.ub));
+    }
+
     static LinearComp instance;
 };
 
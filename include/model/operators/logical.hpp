@@ -21,6 +21,10 @@ class Not final : public UnaryOp, public OutBoolOp, public InBoolOp {
         return !operands[0];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return Interval(1.0 - operands[0].ub, 1.0 - operands[0].lb);
+    }
+
     static Not instance;
 };
 
@@ -42,6 +46,15 @@ class And final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(1.0);
+        for (int i = 0; i < nbOperands; ++i) {
+            result.lb = std::min(result.lb, operands[i].lb);
+            result.ub = std::min(result.ub, operands[i].ub);
+        }
+        return result;
+    }
+
     static And instance;
 };
 
@@ -63,6 +76,15 @@ class Or final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(0.0);
+        for (int i = 0; i < nbOperands; ++i) {
+            result.lb = std::max(result.lb, operands[i].lb);
+            result.ub = std::max(result.ub, operands[i].ub);
+        }
+        return result;
+    }
+
     static Or instance;
 };
 
@@ -83,6 +105,16 @@ class Xor final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        bool result = false;
+        for (int i = 0; i < nbOperands; ++i) {
+            if (!operands[i].isPoint())
+                return Interval::boolean();
+            result ^= (bool) operands[i].lb;
+        }
+        return Interval(result);
+    }
+
     static Xor instance;
 };
 }
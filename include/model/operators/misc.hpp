@@ -20,6 +20,34 @@ class Pow final : public BinaryOp, public OutFloatOp, public InFloatOp {
         return std::pow(operands[0], operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        const Interval &x = operands[0];
+        const Interval &y = operands[1];
+        if (y.isPoint() && y.lb == std::round(y.lb)) {
+            // Integer exponent: defined for negative bases too
+            double n = y.lb;
+            if (n == 0.0)
+                return Interval(1.0);
+            Interval a = n > 0.0 ? x : x.inv();
+            Interval base = std::fmod(n, 2.0) == 0.0 ? a.abs() : a;
+            double e = std::abs(n);
+            return Interval(std::pow(base.lb, e), std::pow(base.ub, e));
+        }
+        if (x.lb < 0.0)
+            return Interval();
+        // Monotonic in each operand on each side of x = 1 and y = 0: look at
+        // the corners of the sub-boxes
+        Interval result = Interval::emptySet();
+        double xs[3] = {x.lb, std::min(std::max(1.0, x.lb), x.ub), x.ub};
+        double ys[3] = {y.lb, std::min(std::max(0.0, y.lb), y.ub), y.ub};
+        for (double xv : xs) {
+            for (double yv : ys) {
+                result = result.unite(Interval(std::pow(xv, yv)));
+            }
+        }
+        return result;
+    }
+
     static Pow instance;
 };
 
@@ -33,6 +61,13 @@ class Logb final : public BinaryOp, public OutFloatOp, public InFloatOp {
         return std::log(operands[0]) / std::log(operands[1]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval positive(0.0, std::numeric_limits<double>::infinity());
+        Interval num = increasingBounds(operands[0], positive, std::log);
+        Interval den = increasingBounds(operands[1], positive, std::log);
+        return num / den;
+    }
+
     static Logb instance;
 };
 
@@ -46,6 +81,10 @@ class BinaryMinus final : public BinaryOp, public OutInferIntOp, public InFloatO
         return operands[0] - operands[1];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return operands[0] - operands[1];
+    }
+
     static BinaryMinus instance;
 };
 
@@ -59,6 +98,10 @@ class Div final : public BinaryOp, public OutFloatOp, public InFloatOp {
         return operands[0] / operands[1];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return operands[0] / operands[1];
+    }
+
     static Div instance;
 };
 
@@ -75,6 +118,20 @@ class Idiv final : public BinaryOp, public OutIntOp, public InIntOp {
         return n / d;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        const Interval &n = operands[0];
+        const Interval &d = operands[1];
+        // Division by nonzero integers, then truncation (nondecreasing)
+        Interval quotient = Interval::emptySet();
+        if (d.lb <= -1.0)
+            quotient = quotient.unite(n / Interval(d.lb, std::min(d.ub, -1.0)));
+        if (d.ub >= 1.0)
+            quotient = quotient.unite(n / Interval(std::max(d.lb, 1.0), d.ub));
+        if (quotient.empty())
+            return Interval();
+        return Interval(std::trunc(quotient.lb), std::trunc(quotient.ub));
+    }
+
     static Idiv instance;
 };
 
@@ -91,6 +148,18 @@ class Mod final : public BinaryOp, public OutIntOp, public InIntOp {
         return n % d;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        const Interval &n = operands[0];
+        const Interval &d = operands[1];
+        // The remainder has the sign of n and is smaller than d in absolute value
+        double m = std::max(std::abs(d.lb), std::abs(d.ub)) - 1.0;
+        if (!(m >= 0.0))
+            return Interval();
+        double lb = n.lb >= 0.0 ? 0.0 : std::max(n.lb, -m);
+        double ub = n.ub <= 0.0 ? 0.0 : std::min(n.ub, m);
+        return Interval(lb, ub);
+    }
+
     static Mod instance;
 };
 
@@ -27,6 +27,14 @@ class Sum final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(0.0);
+        for (int i = 0; i < nbOperands; ++i) {
+            result = result + operands[i];
+        }
+        return result;
+    }
+
     static Sum instance;
 };
 
@@ -47,6 +55,14 @@ class Product final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(1.0);
+        for (int i = 0; i < nbOperands; ++i) {
+            result = result * operands[i];
+        }
+        return result;
+    }
+
     static Product instance;
 };
 
@@ -68,6 +84,15 @@ class Min final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(std::numeric_limits<double>::infinity());
+        for (int i = 0; i < nbOperands; ++i) {
+            result.lb = std::min(result.lb, operands[i].lb);
+            result.ub = std::min(result.ub, operands[i].ub);
+        }
+        return result;
+    }
+
     static Min instance;
 };
 
@@ -89,6 +114,15 @@ class Max final : public NaryOp,
         return result;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        Interval result(-std::numeric_limits<double>::infinity());
+        for (int i = 0; i < nbOperands; ++i) {
+            result.lb = std::max(result.lb, operands[i].lb);
+            result.ub = std::max(result.ub, operands[i].ub);
+        }
+        return result;
+    }
+
     static Max instance;
 };
 }
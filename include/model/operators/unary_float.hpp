@@ -5,7 +5,9 @@
 #include "model/operator.hpp"
 #include "model/operators/concepts.hpp"
 
+#include <cassert>
 #include <cmath>
+#include <limits>
 
 namespace umoi {
 namespace operators {
@@ -20,6 +22,10 @@ class Abs final : public UnaryOp, public OutInferIntOp {
         return std::abs(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return operands[0].abs();
+    }
+
     static Abs instance;
 };
 
@@ -33,6 +39,10 @@ class Square final : public UnaryOp, public OutInferIntOp {
         return operands[0] * operands[0];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return operands[0].square();
+    }
+
     static Square instance;
 };
 
@@ -46,6 +56,10 @@ class UnaryMinus final : public UnaryOp, public OutInferIntOp {
         return -operands[0];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return -operands[0];
+    }
+
     static UnaryMinus instance;
 };
 
@@ -60,6 +74,11 @@ class Exp final : public UnaryOp, public OutFloatOp {
         return std::exp(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(), std::exp);
+    }
+
     static Exp instance;
 };
 
@@ -74,6 +93,11 @@ class Log final : public UnaryOp, public OutFloatOp {
         return std::log(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(0.0, std::numeric_limits<double>::infinity()), std::log);
+    }
+
     static Log instance;
 };
 
@@ -88,6 +112,11 @@ class Sqrt final : public UnaryOp, public OutFloatOp {
         return std::sqrt(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(0.0, std::numeric_limits<double>::infinity()), std::sqrt);
+    }
+
     static Sqrt instance;
 };
 
@@ -102,6 +131,11 @@ class Inv final : public UnaryOp, public OutFloatOp {
         return 1.0 / operands[0];
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return operands[0].inv();
+    }
+
     static Inv instance;
 };
 
@@ -116,6 +150,16 @@ class Frac final : public UnaryOp, public OutFloatOp {
         return operands[0] - std::floor(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        const Interval &x = operands[0];
+        if (x.isFinite() && std::floor(x.lb) == std::floor(x.ub)) {
+            double f = std::floor(x.lb);
+            return Interval(x.lb - f, x.ub - f);
+        }
+        return Interval(0.0, 1.0);
+    }
+
     static Frac instance;
 };
 
@@ -130,6 +174,27 @@ class Cos final : public UnaryOp, public OutFloatOp {
         return std::cos(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return cosBounds(operands[0]);
+    }
+
+    static Interval cosBounds(const Interval &x) {
+        const double twoPi = 2.0 * std::acos(-1.0);
+        const double pi = std::acos(-1.0);
+        if (!x.isFinite() || x.width() >= twoPi)
+            return Interval(-1.0, 1.0);
+        double c1 = std::cos(x.lb);
+        double c2 = std::cos(x.ub);
+        Interval ret(std::min(c1, c2), std::max(c1, c2));
+        // Maximum reached at 2k.pi, minimum at (2k+1).pi
+        if (std::ceil(x.lb / twoPi) <= std::floor(x.ub / twoPi))
+            ret.ub = 1.0;
+        if (std::ceil((x.lb - pi) / twoPi) <= std::floor((x.ub - pi) / twoPi))
+            ret.lb = -1.0;
+        return ret;
+    }
+
     static Cos instance;
 };
 
@@ -145,6 +210,12 @@ class Sin final : public UnaryOp, public OutFloatOp {
         return std::sin(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        const double halfPi = 0.5 * std::acos(-1.0);
+        return Cos::cosBounds(operands[0] - Interval(halfPi));
+    }
+
     static Sin instance;
 };
 
@@ -160,6 +231,18 @@ class Tan final : public UnaryOp, public OutFloatOp {
         return std::tan(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        const Interval &x = operands[0];
+        const double pi = std::acos(-1.0);
+        if (!x.isFinite())
+            return Interval();
+        // Only monotonic between two consecutive asymptotes
+        if (std::floor(x.lb / pi + 0.5) != std::floor(x.ub / pi + 0.5))
+            return Interval();
+        return Interval(std::tan(x.lb), std::tan(x.ub));
+    }
+
     static Tan instance;
 };
 
@@ -175,6 +258,11 @@ class Acos final : public UnaryOp, public OutFloatOp {
         return std::acos(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return decreasingBounds(operands[0], Interval(-1.0, 1.0), std::acos);
+    }
+
     static Acos instance;
 };
 
@@ -190,6 +278,11 @@ class Asin final : public UnaryOp, public OutFloatOp {
         return std::asin(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(-1.0, 1.0), std::asin);
+    }
+
     static Asin instance;
 };
 
@@ -205,6 +298,11 @@ class Atan final : public UnaryOp, public OutFloatOp {
         return std::atan(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(), std::atan);
+    }
+
     static Atan instance;
 };
 
@@ -219,6 +317,12 @@ class Cosh final : public UnaryOp, public OutFloatOp {
         return std::cosh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        Interval a = operands[0].abs();
+        return Interval(std::cosh(a.lb), std::cosh(a.ub));
+    }
+
     static Cosh instance;
 };
 
@@ -234,6 +338,11 @@ class Sinh final : public UnaryOp, public OutFloatOp {
         return std::sinh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(), std::sinh);
+    }
+
     static Sinh instance;
 };
 
@@ -249,6 +358,11 @@ class Tanh final : public UnaryOp, public OutFloatOp {
         return std::tanh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(), std::tanh);
+    }
+
     static Tanh instance;
 };
 
@@ -264,6 +378,11 @@ class Acosh final : public UnaryOp, public OutFloatOp {
         return std::acosh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(1.0, std::numeric_limits<double>::infinity()), std::acosh);
+    }
+
     static Acosh instance;
 };
 
@@ -279,6 +398,11 @@ class Asinh final : public UnaryOp, public OutFloatOp {
         return std::asinh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(), std::asinh);
+    }
+
     static Asinh instance;
 };
 
@@ -294,6 +418,11 @@ class Atanh final : public UnaryOp, public OutFloatOp {
         return std::atanh(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        assert (nbOperands == 1);
+        return increasingBounds(operands[0], Interval(-1.0, 1.0), std::atanh);
+    }
+
     static Atanh instance;
 };
 
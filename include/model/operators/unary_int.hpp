@@ -20,6 +20,10 @@ class Round final : public UnaryOp, public OutIntOp {
         return std::round(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return increasingBounds(operands[0], Interval(), std::round);
+    }
+
     static Round instance;
 };
 
@@ -33,6 +37,10 @@ class Floor final : public UnaryOp, public OutIntOp {
         return std::floor(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return increasingBounds(operands[0], Interval(), std::floor);
+    }
+
     static Floor instance;
 };
 
@@ -46,6 +54,10 @@ class Ceil final : public UnaryOp, public OutIntOp {
         return std::ceil(operands[0]);
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        return increasingBounds(operands[0], Interval(), std::ceil);
+    }
+
     static Ceil instance;
 };
 
@@ -59,6 +71,14 @@ class Sign final : public UnaryOp, public OutIntOp {
         return operands[0] >= 0.0 ? 1.0 : -1.0;
     }
 
+    Interval computeBounds(int nbOperands, Interval *operands) const override {
+        if (operands[0].lb >= 0.0)
+            return Interval(1.0);
+        if (operands[0].ub < 0.0)
+            return Interval(-1.0);
+        return Interval(-1.0, 1.0);
+    }
+
     static Sign instance;
 };
 
@@ -13,16 +13,63 @@ class PresolvedModel : public Model {
     void pull(Model &model);
     void apply(const PresolvedModel &model);
 
-    const std::unordered_map<unsigned int, ExpressionId> &mapping() const {
+    // Infeasibility proven during presolve
+    bool infeasible() const { return infeasible_; }
+    void setInfeasible() { infeasible_ = true; }
+
+    // Result cut short by a time limit, that may differ between runs
+    bool timeLimited() const { return timeLimited_; }
+    void setTimeLimited() { timeLimited_ = true; }
+
+    // Expression of this model for each decision of the original model,
+    // indexed by the original expression; invalid for other expressions
+    const std::vector<ExpressionId> &mapping() const {
         return variableMapping_;
     }
-    std::unordered_map<unsigned int, ExpressionId> &mapping() {
-        return variableMapping_;
+    std::vector<ExpressionId> &mapping() { return variableMapping_; }
+    void setMapping(std::uint32_t id, ExpressionId expr);
+    // Mapped expression of an original expression; throws if it has none
+    ExpressionId getMapping(std::uint32_t id) const;
+
+    /*
+     * Undo step for a reduction that removes a decision from the constraints
+     * without a definition in the mapping. When a solution is pushed, the
+     * target is set to the value closest to zero within its bounds such that
+     * lb <= coef * target + sum(coefs * operands) <= ub.
+     */
+    struct PostsolveRecord {
+        ExpressionId target;
+        double coef;
+        std::vector<ExpressionId> operands;
+        std::vector<double> coefs;
+        double lb;
+        double ub;
+    };
+    const std::vector<PostsolveRecord> &postsolveStack() const {
+        return postsolveStack_;
     }
+    void addPostsolve(const PostsolveRecord &record);
+
+    // Hash of the model, its mapping and its postsolve stack
+    std::uint64_t hash() const;
+
+    // Exact serialization of the expressions, the mapping and the postsolve
+    // stack; parameters and values are not saved
+    void save(std::ostream &os) const;
+    void load(std::istream &is);
+
+  protected:
+    // Replay the postsolve stack, latest record first
+    void postsolve();
 
   private:
     // Mapping from the original decisions to the new variables
-    std::unordered_map<unsigned int, ExpressionId> variableMapping_;
+    std::vector<ExpressionId> variableMapping_;
+    // Undo records, in the order of the reductions
+    std::vector<PostsolveRecord> postsolveStack_;
+
+    bool infeasible_;
+    bool timeLimited_;
 };
 } // namespace umoi
 
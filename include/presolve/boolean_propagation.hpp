@@ -0,0 +1,27 @@
+#ifndef __UMO_PRESOLVE_BOOLEAN_PROPAGATION_HPP__
+#define __UMO_PRESOLVE_BOOLEAN_PROPAGATION_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Unit propagation over the AND/OR/XOR structure of the model.
+ *
+ * Constraints and boolean constants are propagated to the operands and to
+ * the parents of each node. Decided decisions and nodes are replaced by
+ * constants, and the remaining AND/OR/XOR nodes lose their decided
+ * operands. A conflict makes the model infeasible.
+ */
+class BooleanPropagation final : public PresolverPass {
+  public:
+    std::string toString() const override { return "booleanPropagation"; }
+
+    void run(PresolvedModel &model) const override;
+
+    class Propagator;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __UMO_PRESOLVE_BOUND_TIGHTENING_HPP__
+#define __UMO_PRESOLVE_BOUND_TIGHTENING_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Feasibility-based bound tightening: bounds are propagated forward from
+ * the operands to the expressions and backward from the constraints to the
+ * operands, until convergence
+ */
+class BoundTightening final : public PresolverPass {
+  public:
+    std::string toString() const override { return "boundTightening"; }
+
+    void run(PresolvedModel &model) const override;
+
+    // Compute the tightened bounds of all expressions; return false if the
+    // model is proven infeasible
+    bool propagate(const PresolvedModel &model,
+                   std::vector<Interval> &bounds) const;
+    // Extend the bounds of the first expressions to the expressions appended
+    // since, by forward propagation only
+    void extend(const PresolvedModel &model,
+                std::vector<Interval> &bounds) const;
+
+    class Propagator;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
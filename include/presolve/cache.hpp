@@ -0,0 +1,51 @@
+#ifndef __UMO_PRESOLVE_CACHE_HPP__
+#define __UMO_PRESOLVE_CACHE_HPP__
+
+#include <string>
+
+#include "model/presolved_model.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Cache of presolve results, keyed by the hash of the presolve input. Each
+ * entry keeps its input, which is compared on a hit.
+ *
+ * It is enabled when the "presolve_cache" parameter of the input is "on".
+ * Entries are kept in memory for the lifetime of the process and, if the
+ * "presolve_cache_dir" parameter is set, saved in that directory to be
+ * shared between runs.
+ */
+class Cache {
+  public:
+    // Cache entry for a stage of the presolve applied to this input
+    Cache(const Model &input, const std::string &stage);
+    Cache(const PresolvedModel &input, const std::string &stage);
+
+    bool enabled() const { return enabled_; }
+    std::uint64_t key() const { return key_; }
+    // File of the entry, or empty if the cache is not saved on disk
+    std::string filename() const;
+
+    // Get the presolved model for the input, with the input parameters
+    bool find(PresolvedModel &result) const;
+    void insert(const PresolvedModel &result) const;
+
+    // Remove the entries kept in memory
+    static void clear();
+
+  private:
+    void init(const Model &input, const std::string &stage);
+
+  private:
+    const Model &input_;
+    bool enabled_;
+    std::uint64_t key_;
+    // Serialized input, when enabled
+    std::string inputData_;
+    std::string directory_;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
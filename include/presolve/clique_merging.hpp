@@ -0,0 +1,26 @@
+#ifndef __UMO_PRESOLVE_CLIQUE_MERGING_HPP__
+#define __UMO_PRESOLVE_CLIQUE_MERGING_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Merging of pairwise conflicts between binary variables of a linearized
+ * model.
+ *
+ * Rows over two binaries that forbid a single assignment define the edges
+ * of a conflict graph over the literals. Maximal cliques are extracted
+ * greedily, and the pairwise rows they cover are replaced by a single
+ * set-packing row per clique.
+ */
+class CliqueMerging final : public PresolverPass {
+  public:
+    std::string toString() const override { return "cliqueMerging"; }
+
+    void run(PresolvedModel &model) const override;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef __UMO_PRESOLVE_DUAL_REDUCTIONS_HPP__
+#define __UMO_PRESOLVE_DUAL_REDUCTIONS_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Reductions of a linearized model based on the objective and on the
+ * direction in which the constraints restrict each variable:
+ *     * dual fixing of variables that can always move towards a better
+ *       objective
+ *     * fixing of columns dominated by another column with the same rows
+ *     * removal of free column singletons with the row that contains them
+ *
+ * The value of a removed column singleton is recovered by a postsolve
+ * record.
+ */
+class DualReductions final : public PresolverPass {
+  public:
+    std::string toString() const override { return "dualReductions"; }
+
+    void run(PresolvedModel &model) const override;
+
+    class Reducer;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
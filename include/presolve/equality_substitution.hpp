@@ -0,0 +1,28 @@
+#ifndef __UMO_PRESOLVE_EQUALITY_SUBSTITUTION_HPP__
+#define __UMO_PRESOLVE_EQUALITY_SUBSTITUTION_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Elimination of the variables defined by equality rows in a linearized
+ * model: singleton and doubleton rows, and rows defining a variable that is
+ * used in a single other row (typically the auxiliary variables introduced
+ * for sums and products).
+ *
+ * The definitions of the eliminated variables are kept as linear
+ * expressions, which recover their values when the solution is pushed.
+ */
+class EqualitySubstitution final : public PresolverPass {
+  public:
+    std::string toString() const override { return "equalitySubstitution"; }
+
+    void run(PresolvedModel &model) const override;
+
+    class Substitution;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef __UMO_PRESOLVE_EQUIVALENT_LITERALS_HPP__
+#define __UMO_PRESOLVE_EQUIVALENT_LITERALS_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Detection and merging of equivalent or complementary boolean expressions:
+ *     * strongly connected components of the binary implications given by
+ *       the constraints and the AND/OR nodes
+ *     * AND/OR/XOR nodes with the same operands up to equivalence
+ *     * candidates with the same signature under random simulation, checked
+ *       exhaustively when they depend on few inputs
+ *
+ * Each class is replaced by its first expression, with the NOT bit for the
+ * complementary ones.
+ */
+class EquivalentLiterals final : public PresolverPass {
+  public:
+    std::string toString() const override { return "equivalentLiterals"; }
+
+    void run(PresolvedModel &model) const override;
+
+    class Detector;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
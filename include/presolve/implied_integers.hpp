@@ -0,0 +1,28 @@
+#ifndef __UMO_PRESOLVE_IMPLIED_INTEGERS_HPP__
+#define __UMO_PRESOLVE_IMPLIED_INTEGERS_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Declaration of implied integer variables as continuous in a linearized
+ * model.
+ *
+ * An integer auxiliary defined by an equality row over integer variables,
+ * with integer ratios between the coefficients, takes an integer value in
+ * any solution: solvers do not need to branch on it. Each row is used for
+ * at most one variable, and the variables it uses must remain integer, so
+ * that the implications cannot be circular. The decisions of the original
+ * model are kept integer.
+ */
+class ImpliedIntegers final : public PresolverPass {
+  public:
+    std::string toString() const override { return "impliedIntegers"; }
+
+    void run(PresolvedModel &model) const override;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
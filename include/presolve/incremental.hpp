@@ -0,0 +1,61 @@
+#ifndef __UMO_PRESOLVE_INCREMENTAL_HPP__
+#define __UMO_PRESOLVE_INCREMENTAL_HPP__
+
+#include "model/model.hpp"
+#include "utils/utils.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace umoi {
+namespace presolve {
+struct LinearSnapshot;
+struct SatSnapshot;
+
+/*
+ * Results of the last ToLinear and ToSat transformations of a model, so
+ * that a model solved again after appending expressions and constraints
+ * only has the new ones translated.
+ *
+ * Each model owns one state, shared with its presolved copies. The
+ * transformations only fill it when the "incremental" parameter is "on".
+ *
+ * A snapshot is only reused if the new presolved model extends the one it
+ * was built from. The presolve runs from scratch on every solve, so the
+ * transformation starts over when a new constraint lets it rewrite earlier
+ * expressions: literals fixed or merged by BooleanPropagation and
+ * EquivalentLiterals, decision bounds changed by BoundTightening, or
+ * expressions removed by Cleanup. For example, OR(!b, !c) appended to a
+ * model with OR(b, c) makes b and c equivalent to opposite literals.
+ *
+ * ToLinear also starts over when the linearization parameters change, when
+ * an existing comparison or constraint is newly enforced, when a one-sided
+ * relaxation no longer holds for the new directions, or when a new
+ * expression uses an inlined one. Only the translation is incremental: the
+ * row reductions of linearize() still run over the whole model.
+ */
+struct IncrementalState {
+    std::mutex mutex;
+    std::shared_ptr<LinearSnapshot> linear;
+    std::shared_ptr<SatSnapshot> sat;
+    // Number of transformations that started from a snapshot
+    std::uint32_t nbLinearReused = 0;
+    std::uint32_t nbSatReused = 0;
+};
+
+// State to be used by the transformations of the model, or null
+inline std::shared_ptr<IncrementalState>
+incrementalStateOf(const Model &model) {
+    const std::string &param = model.getStringParameter("incremental");
+    if (param != "on" && param != "off")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid incremental parameter");
+    if (param == "off")
+        return nullptr;
+    return model.incrementalState();
+}
+} // namespace presolve
+} // namespace umoi
+
+#endif
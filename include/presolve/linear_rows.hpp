@@ -0,0 +1,83 @@
+#ifndef __UMO_PRESOLVE_LINEAR_ROWS_HPP__
+#define __UMO_PRESOLVE_LINEAR_ROWS_HPP__
+
+#include "model/presolved_model.hpp"
+#include "presolve/rewriter.hpp"
+
+#include <cmath>
+
+namespace umoi {
+namespace presolve {
+/*
+ * Linear constraint lb <= sum(coefs * vars) <= ub of a linearized model
+ */
+struct LinearRow {
+    // Original constraint expression
+    std::uint32_t constraint;
+    std::vector<std::uint32_t> vars;
+    std::vector<double> coefs;
+    double lb;
+    double ub;
+    bool removed;
+    bool modified;
+
+    bool isEquality() const { return lb == ub && std::isfinite(lb); }
+    // Bounds of the row given the bounds of the variables
+    Interval activity(const std::vector<Interval> &bounds) const;
+};
+
+/*
+ * Row view of a model made of linear constraints over decisions, shared by
+ * the passes that run after linearization.
+ *
+ * Passes modify the rows and the variable bounds in place, then the new
+ * model is created with rewriteDecisions() and rewriteRows(): variables with
+ * a single value become constants and are removed from the rows. Variables
+ * marked as eliminated must be replaced by the pass in between.
+ */
+class LinearRows {
+  public:
+    LinearRows(const PresolvedModel &model);
+
+    // Only models made of linear constraints on decisions are handled
+    static bool valid(const PresolvedModel &model);
+
+    std::vector<LinearRow> &rows() { return rows_; }
+    const std::vector<LinearRow> &rows() const { return rows_; }
+    // Bounds of the variables, indexed by expression
+    std::vector<Interval> &bounds() { return bounds_; }
+    const std::vector<Interval> &bounds() const { return bounds_; }
+
+    // Variables removed from all rows by the pass, indexed by expression
+    std::vector<char> &eliminated() { return eliminated_; }
+    const std::vector<char> &eliminated() const { return eliminated_; }
+
+    bool isInteger(std::uint32_t var) const;
+
+    // Create the decisions that are kept, with their new bounds
+    void rewriteDecisions(Rewriter &rewriter) const;
+    // Create the modified rows and remove the others; linear objectives are
+    // rewritten on the remaining decisions
+    void rewriteRows(Rewriter &rewriter) const;
+
+    // Tolerance to decide feasibility and redundancy
+    static constexpr double feasibilityTolerance = 1.0e-9;
+
+  private:
+    void rewriteObjectives(Rewriter &rewriter) const;
+    // Add the terms of an original expression to a linear objective
+    void addObjectiveTerms(Rewriter &rewriter, ExpressionId id, double coef,
+                           std::vector<double> &coefs,
+                           std::vector<ExpressionId> &vars,
+                           double &constant) const;
+
+  private:
+    const PresolvedModel &model_;
+    std::vector<LinearRow> rows_;
+    std::vector<Interval> bounds_;
+    std::vector<char> eliminated_;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __UMO_PRESOLVE_PARALLEL_ROWS_HPP__
+#define __UMO_PRESOLVE_PARALLEL_ROWS_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Detection of duplicate and parallel linear constraints.
+ *
+ * Rows are normalized (variables sorted, first coefficient scaled to one)
+ * and hashed; rows with the same normalized coefficients are merged by
+ * intersecting their bounds.
+ */
+class ParallelRows final : public PresolverPass {
+  public:
+    std::string toString() const override { return "parallelRows"; }
+
+    void run(PresolvedModel &model) const override;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
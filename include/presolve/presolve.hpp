@@ -18,6 +18,9 @@ class PresolverPass {
 
 PresolvedModel run(Model &model);
 
+// Linearize the model and simplify the resulting linear constraints
+void linearize(PresolvedModel &model);
+
 } // namespace presolve
 } // namespace umoi
 
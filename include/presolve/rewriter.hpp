@@ -0,0 +1,43 @@
+#ifndef __UMO_PRESOLVE_REWRITER_HPP__
+#define __UMO_PRESOLVE_REWRITER_HPP__
+
+#include "model/presolved_model.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Helper for presolve passes that rebuild the model.
+ *
+ * Expressions are copied to a new model in topological order. A pass may
+ * replace some of them beforehand, or process them one by one with
+ * replace() and copy(); the remaining ones are copied as is by run(),
+ * which then applies the new model to the original one.
+ */
+class Rewriter {
+  public:
+    Rewriter(PresolvedModel &model);
+
+    // Use an expression of the new model in place of an original expression
+    void replace(std::uint32_t i, ExpressionId newId);
+    bool replaced(std::uint32_t i) const { return mapping_[i].valid(); }
+    // Expression of the new model for an original (compressed) expression
+    ExpressionId get(ExpressionId id);
+    // Copy an original expression, with its operands renamed
+    ExpressionId copy(std::uint32_t i);
+
+    // Copy the remaining expressions, the constraints and the objectives,
+    // then apply the new model to the original one
+    void run();
+
+    const PresolvedModel &model() const { return model_; }
+    PresolvedModel &newModel() { return newModel_; }
+
+  private:
+    PresolvedModel &model_;
+    PresolvedModel newModel_;
+    std::vector<ExpressionId> mapping_;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef __UMO_PRESOLVE_ROW_PRESOLVE_HPP__
+#define __UMO_PRESOLVE_ROW_PRESOLVE_HPP__
+
+#include "presolve/presolve.hpp"
+
+namespace umoi {
+namespace presolve {
+/*
+ * Activity-based presolve of the linear constraints of a linearized model.
+ *
+ * The minimum and maximum activity of each row are computed from the bounds
+ * of its variables to remove redundant rows, detect infeasible ones,
+ * convert singleton rows to bounds, fix the variables of forcing rows and
+ * tighten the coefficients of binary variables.
+ */
+class RowPresolve final : public PresolverPass {
+  public:
+    std::string toString() const override { return "rowPresolve"; }
+
+    void run(PresolvedModel &model) const override;
+
+    class Reducer;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __UMO_PRESOLVE_SYMMETRY_BREAKING_HPP__
+#define __UMO_PRESOLVE_SYMMETRY_BREAKING_HPP__
+
+#include "presolve/presolve.hpp"
+
+#include <vector>
+
+namespace umoi {
+namespace presolve {
+/*
+ * Detection of the symmetries of the model and symmetry-breaking
+ * constraints.
+ *
+ * The model is seen as a colored graph over the expressions, where colors
+ * represent the operators, constants, constraints and objectives, and edge
+ * labels the position and the NOT/MINUS bits of the operands. Generators of
+ * its automorphism group are found by partition refinement and
+ * individualization, and are checked before use.
+ *
+ * For each generator, the first decision it moves is constrained to be at
+ * least as large as its image, which keeps the lexicographically largest
+ * solution of each orbit. Enabled by the "symmetry_breaking" parameter, with
+ * a time budget given by "symmetry_time_limit".
+ */
+class SymmetryBreaking final : public PresolverPass {
+  public:
+    std::string toString() const override { return "symmetryBreaking"; }
+
+    void run(PresolvedModel &model) const override;
+
+    // Generators of the automorphism group found within the time limit, as
+    // permutations of the expressions; timedOut tells whether the search
+    // was stopped by the time limit
+    std::vector<std::vector<std::uint32_t>>
+    generators(const PresolvedModel &model, double timeLimit,
+               bool *timedOut = nullptr) const;
+
+    class Graph;
+};
+} // namespace presolve
+} // namespace umoi
+
+#endif
@@ -10,7 +10,9 @@ class ToLinear final : public PresolverPass {
   public:
     std::string toString() const override { return "toLinear"; }
 
-    bool valid(const PresolvedModel &model) const;
+    // With linearOnly, check the model as if indicator constraints and
+    // quadratic terms were disabled, for backends that read neither
+    bool valid(const PresolvedModel &model, bool linearOnly = false) const;
     void run(PresolvedModel &model) const override;
 
     class Transformer;
@@ -2,6 +2,7 @@
 #ifndef __UMO_UTILS_HPP__
 #define __UMO_UTILS_HPP__
 
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
 
@@ -12,4 +13,16 @@
         throw std::runtime_error(ss.str());                                    \
     } while (0)
 
+namespace umoi {
+// Deterministic combination of 64-bit hashes, stable across platforms
+inline std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value) {
+    std::uint64_t h =
+        seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+} // namespace umoi
+
 #endif
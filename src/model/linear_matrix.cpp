@@ -0,0 +1,214 @@
+#include "model/linear_matrix.hpp"
+
+#include "model/operator.hpp"
+#include "utils/utils.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+namespace umoi {
+
+constexpr int32_t LinearMatrix::InvalidIndex;
+
+LinearMatrix::LinearMatrix(const Model &m) : m_(m) {
+    initColumns();
+    initRows();
+    initColumnForm();
+    initObjectives();
+}
+
+void LinearMatrix::initColumns() {
+    exprToCol_.assign(m_.nbExpressions(), InvalidIndex);
+    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = m_.expression(i);
+        if (!Operator::get(expr.op).isDecision())
+            continue;
+        exprToCol_[i] = colExpr_.size();
+        colExpr_.push_back(i);
+        if (expr.op == UMO_OP_DEC_BOOL) {
+            colType_.push_back(UMO_TYPE_BOOL);
+            colLb_.push_back(0.0);
+            colUb_.push_back(1.0);
+        } else {
+            colType_.push_back(expr.op == UMO_OP_DEC_INT ? UMO_TYPE_INT
+                                                         : UMO_TYPE_FLOAT);
+            colLb_.push_back(m_.getExpressionIdValue(expr.operands[0]));
+            colUb_.push_back(m_.getExpressionIdValue(expr.operands[1]));
+        }
+    }
+}
+
+bool LinearMatrix::isQuadratic(ExpressionId id) const {
+    const Model::ExpressionData &expr = m_.expression(id.var());
+    if (expr.op != UMO_OP_PROD || id.isNot())
+        return false;
+    int nbVariables = 0;
+    for (ExpressionId op : expr.operands) {
+        if (m_.isConstant(op.var()))
+            continue;
+        if (exprToCol_[op.var()] == InvalidIndex || op.isNot())
+            return false;
+        ++nbVariables;
+    }
+    return nbVariables == 2;
+}
+
+void LinearMatrix::addTerm(ExpressionId id, double coef, vector<double> &dense,
+                           vector<uint32_t> &cols,
+                           vector<QuadraticTerm> &quadratic,
+                           double &constant) const {
+    if (m_.isConstant(id.var())) {
+        constant += coef * m_.getExpressionIdValue(id);
+        return;
+    }
+    if (id.isMinus())
+        coef = -coef;
+    if (isQuadratic(id)) {
+        QuadraticTerm term;
+        vector<uint32_t> vars;
+        for (ExpressionId op : m_.expression(id.var()).operands) {
+            if (m_.isConstant(op.var())) {
+                coef *= m_.getExpressionIdValue(op);
+                continue;
+            }
+            if (op.isMinus())
+                coef = -coef;
+            vars.push_back(exprToCol_[op.var()]);
+        }
+        term.col1 = vars[0];
+        term.col2 = vars[1];
+        term.coef = coef;
+        quadratic.push_back(term);
+        return;
+    }
+    int32_t col = exprToCol_[id.var()];
+    if (col == InvalidIndex) {
+        THROW_ERROR("Operator " << m_.expression(id.var()).op
+                                << " is not handled by the linear matrix");
+    }
+    if (id.isNot()) {
+        // 1 - x for a boolean
+        constant += coef;
+        coef = -coef;
+    }
+    if (dense[col] == 0.0)
+        cols.push_back(col);
+    dense[col] += coef;
+}
+
+void LinearMatrix::initRows() {
+    // Coefficients of the current row, indexed by column
+    vector<double> dense(nbColumns(), 0.0);
+    vector<uint32_t> cols;
+    rowStart_.push_back(0);
+    quadStart_.push_back(0);
+    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
+        if (!m_.isConstraint(i))
+            continue;
+        const Model::ExpressionData &expr = m_.expression(i);
+        uint32_t row = i;
+        int32_t indicator = InvalidIndex;
+        bool indicatorValue = false;
+        if (expr.op == UMO_OP_OR && expr.operands.size() == 2 &&
+            !m_.isConstraintNeg(i)) {
+            // Indicator constraint lit || row: the row is enforced when the
+            // literal is false
+            ExpressionId lit = expr.operands[0];
+            ExpressionId enforced = expr.operands[1];
+            if (m_.expression(lit.var()).op != UMO_OP_DEC_BOOL ||
+                lit.isMinus() ||
+                m_.expression(enforced.var()).op != UMO_OP_LINEARCOMP ||
+                enforced.isNot() || enforced.isMinus() ||
+                m_.isConstraint(enforced.var())) {
+                THROW_ERROR("Disjunctions must be indicator constraints for "
+                            "the linear matrix");
+            }
+            row = enforced.var();
+            indicator = exprToCol_[lit.var()];
+            indicatorValue = lit.isNot();
+        } else if (expr.op != UMO_OP_LINEARCOMP || m_.isConstraintNeg(i)) {
+            THROW_ERROR("Operator " << expr.op
+                                    << " is not handled as a constraint by "
+                                       "the linear matrix");
+        }
+        const Model::ExpressionData &rowExpr = m_.expression(row);
+        double constant = 0.0;
+        for (uint32_t j = 1; 2 * j + 1 < rowExpr.operands.size(); ++j) {
+            double coef = m_.getExpressionIdValue(rowExpr.operands[2 * j]);
+            addTerm(rowExpr.operands[2 * j + 1], coef, dense, cols, quadTerms_,
+                    constant);
+        }
+        for (uint32_t col : cols) {
+            // Duplicate columns and cancelled coefficients are skipped
+            if (dense[col] == 0.0)
+                continue;
+            rowIndex_.push_back(col);
+            rowValue_.push_back(dense[col]);
+            dense[col] = 0.0;
+        }
+        cols.clear();
+        rowStart_.push_back(rowIndex_.size());
+        quadStart_.push_back(quadTerms_.size());
+        rowExpr_.push_back(row);
+        rowLb_.push_back(m_.getExpressionIdValue(rowExpr.operands[0]) -
+                         constant);
+        rowUb_.push_back(m_.getExpressionIdValue(rowExpr.operands[1]) -
+                         constant);
+        rowIndicator_.push_back(indicator);
+        rowIndicatorValue_.push_back(indicatorValue);
+    }
+}
+
+void LinearMatrix::initColumnForm() {
+    // Counting sort of the entries by column; rows stay sorted in each column
+    colStart_.assign(nbColumns() + 1, 0);
+    for (uint32_t col : rowIndex_) {
+        ++colStart_[col + 1];
+    }
+    for (uint32_t col = 0; col < nbColumns(); ++col) {
+        colStart_[col + 1] += colStart_[col];
+    }
+    colIndex_.resize(nbNonZeros());
+    colValue_.resize(nbNonZeros());
+    vector<uint32_t> next(colStart_.begin(), colStart_.end() - 1);
+    for (uint32_t row = 0; row < nbRows(); ++row) {
+        for (uint32_t k = rowStart_[row]; k < rowStart_[row + 1]; ++k) {
+            uint32_t pos = next[rowIndex_[k]]++;
+            colIndex_[pos] = row;
+            colValue_[pos] = rowValue_[k];
+        }
+    }
+}
+
+void LinearMatrix::initObjectives() {
+    for (const Model::ObjectiveData &data : m_.objectives()) {
+        Objective obj;
+        obj.expr = data.first;
+        obj.maximize = data.second == UMO_OBJ_MAXIMIZE;
+        obj.linear = false;
+        obj.offset = 0.0;
+        const Model::ExpressionData &expr = m_.expression(data.first.var());
+        if (expr.op == UMO_OP_LINEAR ||
+            exprToCol_[data.first.var()] != InvalidIndex) {
+            obj.linear = true;
+            obj.coefs.assign(nbColumns(), 0.0);
+            vector<uint32_t> cols;
+            if (expr.op != UMO_OP_LINEAR) {
+                addTerm(data.first, 1.0, obj.coefs, cols, obj.quadratic,
+                        obj.offset);
+            } else {
+                double sign = data.first.isMinus() ? -1.0 : 1.0;
+                for (uint32_t j = 0; 2 * j + 1 < expr.operands.size(); ++j) {
+                    double coef =
+                        sign * m_.getExpressionIdValue(expr.operands[2 * j]);
+                    addTerm(expr.operands[2 * j + 1], coef, obj.coefs, cols,
+                            obj.quadratic, obj.offset);
+                }
+            }
+        }
+        objectives_.push_back(obj);
+    }
+}
+
+} // namespace umoi
@@ -4,11 +4,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <sstream>
 #include <stdexcept>
 
 #include "model/operator.hpp"
 #include "utils/utils.hpp"
+#include "presolve/cache.hpp"
+#include "presolve/incremental.hpp"
 #include "presolve/presolve.hpp"
 #include "solver/external_solvers.hpp"
 
@@ -43,9 +47,10 @@ bool isTypeCompatible(umo_type varType, double value) {
 }
 } // namespace
 
-Model::Model() {
+Model::Model() : incrementalState_(make_shared<presolve::IncrementalState>()) {
     computed_ = false;
     statusComputed_ = false;
+    boundsComputed_ = false;
     initDefaultParameters();
 }
 
@@ -56,6 +61,7 @@ ExpressionId Model::createConstant(double value) {
     auto itp = constants_.emplace(value, nbExpressions());
     if (itp.second) {
         // New constant inserted
+        boundsComputed_ = false;
         expressions_.emplace_back(UMO_OP_CONSTANT, computeType(value));
         values_.push_back(value);
     }
@@ -79,6 +85,7 @@ ExpressionId Model::createExpression(umo_operator op,
 
     computed_ = false;
     statusComputed_ = false;
+    boundsComputed_ = false;
     // Gather operands with type info
     ExpressionData expr(op);
     expr.operands = operands;
@@ -123,19 +130,57 @@ double Model::getFloatValue(ExpressionId expr) {
 }
 
 void Model::setFloatValue(ExpressionId expr, double value) {
+    double varValue = checkDecisionValue(expr, value);
+    computed_ = false;
+    statusComputed_ = false;
+    values_[expr.var()] = varValue;
+}
+
+vector<double> Model::getFloatValues(const vector<ExpressionId> &exprs) {
+    if (!computed_)
+        compute();
+    vector<double> values;
+    values.reserve(exprs.size());
+    for (ExpressionId expr : exprs) {
+        values.push_back(getExpressionIdValue(expr));
+    }
+    return values;
+}
+
+void Model::setFloatValues(const vector<ExpressionId> &exprs,
+                           const vector<double> &values) {
+    if (exprs.size() != values.size())
+        THROW_ERROR("Setting " << values.size() << " values for "
+                               << exprs.size() << " decisions");
+    vector<double> varValues;
+    varValues.reserve(values.size());
+    for (size_t i = 0; i < exprs.size(); ++i) {
+        varValues.push_back(checkDecisionValue(exprs[i], values[i]));
+    }
+    for (size_t i = 0; i < exprs.size(); ++i) {
+        values_[exprs[i].var()] = varValues[i];
+    }
+    computed_ = false;
+    statusComputed_ = false;
+}
+
+double Model::checkDecisionValue(ExpressionId expr, double value) const {
     checkExpressionId(expr);
     umo_operator varOp = getExpressionIdOp(expr);
     if (varOp != UMO_OP_DEC_BOOL && varOp != UMO_OP_DEC_INT &&
         varOp != UMO_OP_DEC_FLOAT)
         throw runtime_error("Only decisions can be set");
+    // Value of the variable for a compressed (not/minus) expression
+    if (expr.isMinus())
+        value = -value;
+    if (expr.isNot())
+        value = 1.0 - value;
     umo_type varType = expressions_[expr.var()].type;
     if (!isTypeCompatible(varType, value))
         THROW_ERROR("Cannot set an expression of type " << varType << " to "
                                                         << value << " of type "
                                                         << computeType(value));
-    computed_ = false;
-    statusComputed_ = false;
-    values_[expr.var()] = value;
+    return value;
 }
 
 umo_solution_status Model::getStatus() {
@@ -149,10 +194,33 @@ void Model::setStatus(umo_solution_status status) {
     status_ = status;
 }
 
+Interval Model::getBounds(ExpressionId expr) {
+    checkExpressionId(expr);
+    if (!boundsComputed_)
+        computeBounds();
+    return getExpressionIdBounds(expr);
+}
+
 void Model::solve() {
-    check();
-    PresolvedModel presolved = presolve::run(*this);
-    presolved.check();
+    PresolvedModel presolved;
+    // The symmetry-breaking constraints depend on its parameters
+    stringstream stage;
+    stage << "presolve-" << getStringParameter("symmetry_breaking") << "-"
+          << getFloatParameter("symmetry_time_limit");
+    presolve::Cache cache(*this, stage.str());
+    if (!cache.find(presolved)) {
+        check();
+        presolved = presolve::run(*this);
+        if (!presolved.infeasible())
+            presolved.check();
+        // A result cut short by the time limit may differ between runs
+        if (!presolved.timeLimited())
+            cache.insert(presolved);
+    }
+    if (presolved.infeasible()) {
+        setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string solverParam = getStringParameter("solver");
     if (solverParam == "auto") {
         if (MinisatSolver().valid(presolved))
@@ -201,6 +269,67 @@ void Model::setStringParameter(const string &param, const string &value) {
     stringParams_[param] = value;
 }
 
+void Model::copyParameters(const Model &model) {
+    stringParams_ = model.stringParams_;
+    floatParams_ = model.floatParams_;
+    incrementalState_ = model.incrementalState_;
+}
+
+uint64_t Model::hash() const {
+    // The hash of each expression depends on the hash of its operands, and
+    // the expressions are combined in order
+    vector<uint64_t> exprHashes(nbExpressions());
+    uint64_t ret = hashCombine(0, nbExpressions());
+    for (uint32_t i = 0; i < nbExpressions(); ++i) {
+        const ExpressionData &expr = expressions_[i];
+        uint64_t h = hashCombine(expr.op, expr.type);
+        if (expr.op == UMO_OP_CONSTANT) {
+            uint64_t bits;
+            memcpy(&bits, &values_[i], sizeof(bits));
+            h = hashCombine(h, bits);
+        }
+        for (ExpressionId op : expr.operands) {
+            uint64_t flags = op.raw() & 0x03;
+            h = hashCombine(h, hashCombine(exprHashes[op.var()], flags));
+        }
+        exprHashes[i] = h;
+        ret = hashCombine(ret, h);
+    }
+    // Constraints are unordered
+    vector<ExpressionId> constraints(constraints_.begin(), constraints_.end());
+    sort(constraints.begin(), constraints.end());
+    ret = hashCombine(ret, constraints.size());
+    for (ExpressionId c : constraints) {
+        ret = hashCombine(ret, c.raw());
+    }
+    ret = hashCombine(ret, objectives_.size());
+    for (const ObjectiveData &obj : objectives_) {
+        ret = hashCombine(hashCombine(ret, obj.first.raw()), obj.second);
+    }
+    return ret;
+}
+
+bool Model::extends(const Model &other) const {
+    if (other.nbExpressions() > nbExpressions() ||
+        other.objectives_ != objectives_)
+        return false;
+    for (uint32_t i = 0; i < other.nbExpressions(); ++i) {
+        const ExpressionData &expr = expressions_[i];
+        const ExpressionData &prev = other.expressions_[i];
+        if (expr.op != prev.op || expr.type != prev.type ||
+            expr.operands != prev.operands)
+            return false;
+        if (expr.op == UMO_OP_CONSTANT &&
+            memcmp(&values_[i], &other.values_[i], sizeof(double)) != 0)
+            return false;
+    }
+    for (ExpressionId c : other.constraints_) {
+        if (!constraints_.count(c))
+            return false;
+    }
+    return true;
+}
+
 void Model::checkExpressionId(ExpressionId expr) const {
     if (expr.var() >= nbExpressions())
         throw runtime_error("Expression is out of bounds");
@@ -234,6 +363,15 @@ double Model::getExpressionIdValue(ExpressionId expr) const {
     return val;
 }
 
+Interval Model::getExpressionIdBounds(ExpressionId expr) const {
+    Interval bounds = bounds_[expr.var()];
+    if (expr.isNot())
+        bounds = Interval(1.0 - bounds.ub, 1.0 - bounds.lb);
+    if (expr.isMinus())
+        bounds = -bounds;
+    return bounds;
+}
+
 vector<ExpressionId> Model::getExpressionIdOperands(ExpressionId expr) const {
     if (expr.isNot())
         return {expr.getNot()};
@@ -360,12 +498,13 @@ void Model::checkCompressedOperands() const {
 
 void Model::compute() {
     // Compute all expressions
+    vector<double> operands;
     for (uint32_t i = 0; i < nbExpressions(); ++i) {
         const ExpressionData &expr = expressions_[i];
         const Operator &op = Operator::get(expr.op);
         if (op.isLeaf())
             continue;
-        vector<double> operands;
+        operands.clear();
         for (ExpressionId id : expr.operands) {
             operands.push_back(getExpressionIdValue(id));
         }
@@ -374,6 +513,44 @@ void Model::compute() {
     computed_ = true;
 }
 
+void Model::computeBounds() {
+    // Single pass in topological order
+    bounds_.resize(nbExpressions());
+    vector<Interval> operands;
+    for (uint32_t i = 0; i < nbExpressions(); ++i) {
+        const ExpressionData &expr = expressions_[i];
+        if (expr.op == UMO_OP_CONSTANT) {
+            bounds_[i] = Interval(values_[i]);
+            continue;
+        }
+        if (expr.op == UMO_OP_INVALID) {
+            bounds_[i] = Interval();
+            continue;
+        }
+        operands.clear();
+        bool emptyOperand = false;
+        for (ExpressionId id : expr.operands) {
+            operands.push_back(getExpressionIdBounds(id));
+            emptyOperand |= operands.back().empty();
+        }
+        if (emptyOperand) {
+            // Infeasibility propagates
+            bounds_[i] = Interval::emptySet();
+            continue;
+        }
+        Interval bounds = Operator::get(expr.op).computeBounds(
+            operands.size(), operands.data());
+        if (std::isnan(bounds.lb) || std::isnan(bounds.ub))
+            bounds = Interval();
+        if (expr.type != UMO_TYPE_FLOAT)
+            bounds = bounds.roundInward();
+        if (expr.type == UMO_TYPE_BOOL)
+            bounds = bounds.intersect(Interval::boolean());
+        bounds_[i] = bounds;
+    }
+    boundsComputed_ = true;
+}
+
 void Model::computeStatus() {
     if (!computed_)
         compute();
@@ -392,5 +569,15 @@ void Model::computeStatus() {
 void Model::initDefaultParameters() {
     setFloatParameter("time_limit", numeric_limits<double>::infinity());
     setStringParameter("solver", "auto");
+    setStringParameter("presolve_cache", "off");
+    setStringParameter("presolve_cache_dir", "");
+    setStringParameter("symmetry_breaking", "off");
+    setFloatParameter("symmetry_time_limit", 1.0);
+    setStringParameter("indicator_constraints", "off");
+    setStringParameter("xor_encoding", "auto");
+    setStringParameter("piecewise_linear", "off");
+    setFloatParameter("piecewise_tolerance", 1.0e-3);
+    setStringParameter("linearization_target", "linear");
+    setStringParameter("incremental", "off");
 }
 } // namespace umoi
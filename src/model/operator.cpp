@@ -202,6 +202,10 @@ umo_type Operator::resultType(int nbOperands, umo_type *operandTypes,
     return UMO_TYPE_FLOAT;
 }
 
+Interval Operator::computeBounds(int nbOperands, Interval *operands) const {
+    return Interval();
+}
+
 Constant Constant::instance;
 DecBool DecBool::instance;
 DecInt DecInt::instance;
@@ -2,39 +2,112 @@
 #include "model/presolved_model.hpp"
 
 #include "model/operator.hpp"
+#include "utils/utils.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 #include <stdexcept>
 
 using namespace std;
 
 namespace umoi {
-PresolvedModel::PresolvedModel() {}
+PresolvedModel::PresolvedModel() : infeasible_(false), timeLimited_(false) {}
 
-PresolvedModel::PresolvedModel(const Model &model) : Model(model) {
+PresolvedModel::PresolvedModel(const Model &model)
+    : Model(model), variableMapping_(model.nbExpressions()),
+      infeasible_(false), timeLimited_(false) {
     for (size_t i = 0; i < expressions_.size(); ++i) {
         if (Operator::get(expressions_[i].op).isDecision()) {
-            variableMapping_.emplace(i, ExpressionId(i, false, false));
+            variableMapping_[i] = ExpressionId(i, false, false);
         }
     }
 }
 
+void PresolvedModel::setMapping(uint32_t id, ExpressionId expr) {
+    if (id >= variableMapping_.size())
+        variableMapping_.resize(id + 1);
+    variableMapping_[id] = expr;
+}
+
+ExpressionId PresolvedModel::getMapping(uint32_t id) const {
+    if (id >= variableMapping_.size() || !variableMapping_[id].valid())
+        THROW_ERROR("Expression " << id << " has no mapped expression");
+    return variableMapping_[id];
+}
+
+void PresolvedModel::addPostsolve(const PostsolveRecord &record) {
+    postsolveStack_.push_back(record);
+}
+
+void PresolvedModel::postsolve() {
+    if (postsolveStack_.empty())
+        return;
+    if (!computed_)
+        compute();
+    for (auto it = postsolveStack_.rbegin(); it != postsolveStack_.rend();
+         ++it) {
+        const PostsolveRecord &record = *it;
+        if (!isDecision(record.target.var()))
+            continue;
+        double activity = 0.0;
+        for (size_t j = 0; j < record.operands.size(); ++j) {
+            activity += record.coefs[j] * getExpressionIdValue(record.operands[j]);
+        }
+        Interval feasible = (Interval(record.lb, record.ub) - Interval(activity)) /
+                            Interval(record.coef);
+        // Bounds of the target
+        const ExpressionData &expr = expressions_[record.target.var()];
+        Interval bounds = Interval::boolean();
+        if (expr.op != UMO_OP_DEC_BOOL)
+            bounds = Interval(getExpressionIdValue(expr.operands[0]),
+                              getExpressionIdValue(expr.operands[1]));
+        if (record.target.isNot())
+            bounds = Interval(1.0 - bounds.ub, 1.0 - bounds.lb);
+        if (record.target.isMinus())
+            bounds = -bounds;
+        feasible = feasible.intersect(bounds);
+        if (expr.type != UMO_TYPE_FLOAT)
+            feasible = feasible.roundInward();
+        double val = min(max(0.0, feasible.lb), feasible.ub);
+        // Later records may depend on this value
+        values_[record.target.var()] = checkDecisionValue(record.target, val);
+    }
+    computed_ = false;
+    statusComputed_ = false;
+}
+
 void PresolvedModel::push(Model &model) {
-    for (auto p : variableMapping_) {
-        double val = getFloatValue(p.second);
-        model.setFloatValue(ExpressionId(p.first, false, false), val);
+    // Status set by the solver, before postsolve marks the values as changed
+    umo_solution_status status = getStatus();
+    // Values of an infeasible model are meaningless for the removed columns
+    if (status != UMO_STATUS_INFEASIBLE)
+        postsolve();
+    vector<ExpressionId> decisions;
+    vector<ExpressionId> definitions;
+    for (uint32_t i = 0; i < variableMapping_.size(); ++i) {
+        if (!variableMapping_[i].valid())
+            continue;
+        decisions.push_back(ExpressionId(i, false, false));
+        definitions.push_back(variableMapping_[i]);
     }
+    model.setFloatValues(decisions, getFloatValues(definitions));
     // Push status for a model declared optimal or unfeasible
-    model.setStatus(getStatus());
+    model.setStatus(status);
 }
 
 void PresolvedModel::pull(Model &model) {
-    for (auto p : variableMapping_) {
-        double val = model.getFloatValue(ExpressionId(p.first, false, false));
-        if (Operator::get(getExpressionIdOp(p.second)).isDecision()) {
-            // Only set decisions in the presolved model
-            setFloatValue(p.second, val);
-        }
+    vector<ExpressionId> decisions;
+    vector<ExpressionId> originals;
+    for (uint32_t i = 0; i < variableMapping_.size(); ++i) {
+        ExpressionId expr = variableMapping_[i];
+        // Only set decisions in the presolved model
+        if (!expr.valid() || !Operator::get(getExpressionIdOp(expr)).isDecision())
+            continue;
+        decisions.push_back(expr);
+        originals.push_back(ExpressionId(i, false, false));
     }
+    setFloatValues(decisions, model.getFloatValues(originals));
 }
 
 namespace {
@@ -46,27 +119,220 @@ ExpressionId composeExpressions(ExpressionId expr1, ExpressionId expr2) {
     bool isMinus = expr1.isMinus() ^ expr2.isMinus();
     return ExpressionId(expr2.var(), isNot, isMinus);
 }
+
+// Expression of the next model for an expression of the previous one
+ExpressionId composeMapping(const PresolvedModel &prev, PresolvedModel &next,
+                            ExpressionId expr) {
+    const vector<ExpressionId> &map2 = next.mapping();
+    if (expr.var() < map2.size() && map2[expr.var()].valid())
+        return composeExpressions(expr, map2[expr.var()]);
+    if (prev.isConstant(expr.var())) {
+        // Constants are not always mapped: recreate them in the new model
+        return next.createConstant(prev.getExpressionIdValue(expr));
+    }
+    throw runtime_error(
+        "A decision variable was lost when applying a new presolve");
+}
 } // namespace
 
 void PresolvedModel::apply(const PresolvedModel &next) {
-    // Update the decision mapping
-    unordered_map<unsigned int, ExpressionId> newMapping;
-    const auto &map1 = variableMapping_;
-    const auto &map2 = next.variableMapping_;
-    for (auto p : map1) {
-        // Find its definition in map2
-        ExpressionId expr1 = p.second;
-        auto it = map2.find(expr1.var());
-        if (it == map2.end())
-            throw runtime_error(
-                "A decision variable was lost when applying a new presolve");
-        ExpressionId expr2 = it->second;
-        ExpressionId composed = composeExpressions(expr1, expr2);
-        // Now apply the NOT/MINUS operations and push the new definition
-        newMapping.emplace(p.first, composed);
-    }
-
-    *this = next;
-    variableMapping_ = newMapping;
+    PresolvedModel result = next;
+    // Update the decision mapping and the postsolve stack
+    for (ExpressionId &expr : variableMapping_) {
+        if (expr.valid())
+            expr = composeMapping(*this, result, expr);
+    }
+    for (PostsolveRecord &record : postsolveStack_) {
+        record.target = composeMapping(*this, result, record.target);
+        for (ExpressionId &op : record.operands) {
+            op = composeMapping(*this, result, op);
+        }
+    }
+    postsolveStack_.insert(postsolveStack_.end(),
+                           next.postsolveStack_.begin(),
+                           next.postsolveStack_.end());
+    result.variableMapping_ = move(variableMapping_);
+    result.postsolveStack_ = move(postsolveStack_);
+
+    // Keep the parameters of the original model
+    result.stringParams_ = stringParams_;
+    result.floatParams_ = floatParams_;
+    result.incrementalState_ = incrementalState_;
+    result.infeasible_ = infeasible_ || next.infeasible_;
+    result.timeLimited_ = timeLimited_ || next.timeLimited_;
+    *this = move(result);
+}
+
+namespace {
+// Doubles are saved as their bit pattern to be read back exactly
+uint64_t toBits(double val) {
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+} // namespace
+
+uint64_t PresolvedModel::hash() const {
+    uint64_t ret = Model::hash();
+    ret = hashCombine(ret, variableMapping_.size());
+    for (ExpressionId expr : variableMapping_) {
+        ret = hashCombine(ret, expr.raw());
+    }
+    ret = hashCombine(ret, postsolveStack_.size());
+    for (const PostsolveRecord &record : postsolveStack_) {
+        ret = hashCombine(ret, record.target.raw());
+        ret = hashCombine(ret, toBits(record.coef));
+        ret = hashCombine(ret, record.operands.size());
+        for (size_t j = 0; j < record.operands.size(); ++j) {
+            ret = hashCombine(ret, record.operands[j].raw());
+            ret = hashCombine(ret, toBits(record.coefs[j]));
+        }
+        ret = hashCombine(ret, toBits(record.lb));
+        ret = hashCombine(ret, toBits(record.ub));
+    }
+    return hashCombine(ret, infeasible_);
+}
+
+namespace {
+double fromBits(uint64_t bits) {
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+const char *saveHeader = "umo_presolved";
+const int saveVersion = 1;
+} // namespace
+
+void PresolvedModel::save(ostream &os) const {
+    os << saveHeader << " " << saveVersion << "\n";
+    os << nbExpressions() << "\n";
+    for (uint32_t i = 0; i < nbExpressions(); ++i) {
+        const ExpressionData &expr = expressions_[i];
+        os << (int)expr.op << " " << (int)expr.type;
+        if (expr.op == UMO_OP_CONSTANT) {
+            os << " " << toBits(values_[i]);
+        } else {
+            os << " " << expr.operands.size();
+            for (ExpressionId op : expr.operands) {
+                os << " " << op.raw();
+            }
+        }
+        os << "\n";
+    }
+    vector<ExpressionId> constraints(constraints_.begin(), constraints_.end());
+    sort(constraints.begin(), constraints.end());
+    os << constraints.size();
+    for (ExpressionId c : constraints) {
+        os << " " << c.raw();
+    }
+    os << "\n" << objectives_.size();
+    for (const ObjectiveData &obj : objectives_) {
+        os << " " << obj.first.raw() << " " << (int)obj.second;
+    }
+    os << "\n" << variableMapping_.size();
+    for (ExpressionId expr : variableMapping_) {
+        os << " " << expr.raw();
+    }
+    os << "\n" << postsolveStack_.size() << "\n";
+    for (const PostsolveRecord &record : postsolveStack_) {
+        os << record.target.raw() << " " << toBits(record.coef) << " "
+           << record.operands.size();
+        for (size_t j = 0; j < record.operands.size(); ++j) {
+            os << " " << record.operands[j].raw() << " "
+               << toBits(record.coefs[j]);
+        }
+        os << " " << toBits(record.lb) << " " << toBits(record.ub) << "\n";
+    }
+    os << infeasible_ << endl;
+}
+
+void PresolvedModel::load(istream &is) {
+    string header;
+    int version = 0;
+    is >> header >> version;
+    if (!is || header != saveHeader || version != saveVersion)
+        throw runtime_error("Invalid presolved model header");
+    PresolvedModel ret;
+    ret.copyParameters(*this);
+    uint32_t nbExprs = 0;
+    is >> nbExprs;
+    // Read an expression that must be defined before the given one
+    auto readId = [&](uint32_t before) {
+        uint32_t raw = -1;
+        is >> raw;
+        ExpressionId id = ExpressionId::fromRaw(raw);
+        if (!is || id.var() >= before)
+            throw runtime_error("Invalid expression in presolved model");
+        return id;
+    };
+    for (uint32_t i = 0; i < nbExprs && is; ++i) {
+        int op = 0;
+        int type = 0;
+        is >> op >> type;
+        if (op < 0 || op >= UMO_OP_END)
+            throw runtime_error("Invalid operator in presolved model");
+        ExpressionData expr((umo_operator)op, (umo_type)type);
+        double val = 0.0;
+        if (op == UMO_OP_CONSTANT) {
+            uint64_t bits = 0;
+            is >> bits;
+            val = fromBits(bits);
+            ret.constants_.emplace(val, i);
+        } else {
+            size_t nbOperands = 0;
+            is >> nbOperands;
+            for (size_t j = 0; j < nbOperands && is; ++j) {
+                expr.operands.push_back(readId(i));
+            }
+        }
+        ret.expressions_.push_back(expr);
+        ret.values_.push_back(val);
+    }
+    size_t nb = 0;
+    is >> nb;
+    for (size_t i = 0; i < nb && is; ++i) {
+        ret.constraints_.insert(readId(nbExprs));
+    }
+    is >> nb;
+    for (size_t i = 0; i < nb && is; ++i) {
+        ExpressionId obj = readId(nbExprs);
+        int dir = 0;
+        is >> dir;
+        ret.objectives_.emplace_back(obj, (umo_objective_direction)dir);
+    }
+    is >> nb;
+    ret.variableMapping_.resize(nb);
+    for (size_t i = 0; i < nb && is; ++i) {
+        uint32_t raw = -1;
+        is >> raw;
+        ExpressionId expr = ExpressionId::fromRaw(raw);
+        if (expr.valid() && expr.var() >= nbExprs)
+            throw runtime_error("Invalid mapping in presolved model");
+        ret.variableMapping_[i] = expr;
+    }
+    is >> nb;
+    for (size_t i = 0; i < nb && is; ++i) {
+        PostsolveRecord record;
+        uint64_t bits = 0;
+        size_t nbOperands = 0;
+        record.target = readId(nbExprs);
+        is >> bits >> nbOperands;
+        record.coef = fromBits(bits);
+        for (size_t j = 0; j < nbOperands && is; ++j) {
+            record.operands.push_back(readId(nbExprs));
+            is >> bits;
+            record.coefs.push_back(fromBits(bits));
+        }
+        is >> bits;
+        record.lb = fromBits(bits);
+        is >> bits;
+        record.ub = fromBits(bits);
+        ret.postsolveStack_.push_back(record);
+    }
+    is >> ret.infeasible_;
+    if (!is)
+        throw runtime_error("Truncated presolved model");
+    *this = move(ret);
 }
 } // namespace umoi
@@ -1,4 +1,5 @@
 
+#include "model/linear_matrix.hpp"
 #include "model/model.hpp"
 #include "model/operator.hpp"
 #include "utils/utils.hpp"
@@ -25,23 +26,31 @@ class ModelWriterLp {
     static vector<int32_t> getVarToId(const Model &m);
 
   protected:
-    void initVarToId();
-
-    void writeObjective();
-    void writeConstraints();
-    void writeBounds();
-    void writeIntegers();
-
-    string varName(uint32_t i) const;
-    string exprName(ExpressionId id) const;
-    void writeLpLinearExpression(uint32_t i);
+    void writeObjective(const LinearMatrix &matrix);
+    void writeConstraints(const LinearMatrix &matrix);
+    void writeBounds(const LinearMatrix &matrix);
+    void writeIntegers(const LinearMatrix &matrix);
+
+    string varName(uint32_t col) const;
+    // Write linear terms, followed by the quadratic terms between brackets
+    void writeLpTerms(const vector<pair<uint32_t, double>> &terms,
+                      const LinearMatrix::QuadraticTerm *beginQuad,
+                      const LinearMatrix::QuadraticTerm *endQuad,
+                      bool objective);
+    // Write the lines of a row, after an optional condition
+    void writeLpRow(const LinearMatrix &matrix, uint32_t row,
+                    const string &condition);
+    // Whether the expression is an indicator constraint lit || row
+    bool isIndicator(uint32_t i) const;
+    // Whether the expression is a product of two variables and constants
+    bool isQuadratic(ExpressionId id) const;
 
     void check() const;
 
   private:
     const Model &m_;
     ostream &s_;
-    vector<int32_t> varToId_;
+    // Whether each column has been written, indexed by column
     vector<char> variableSeen_;
 };
 
@@ -49,16 +58,24 @@ constexpr int32_t ModelWriterLp::InvalidId;
 
 ModelWriterLp::ModelWriterLp(const Model &m, ostream &s) : m_(m), s_(s) {}
 
-void ModelWriterLp::writeObjective() {
+void ModelWriterLp::writeObjective(const LinearMatrix &matrix) {
     if (m_.nbObjectives() == 1) {
-        ExpressionId obj = m_.objective(0).first;
-        bool dir = (m_.objective(0).second == UMO_OBJ_MAXIMIZE);
-        if (obj.isMinus())
-            dir = !dir;
-        if (obj.isNot())
-            dir = !dir;
-        s_ << (dir ? "Maximize" : "Minimize") << endl;
-        s_ << "\t" << varName(obj.var()) << endl;
+        const LinearMatrix::Objective &obj = matrix.objectives()[0];
+        s_ << (obj.maximize ? "Maximize" : "Minimize") << endl;
+        vector<pair<uint32_t, double>> terms;
+        for (uint32_t col = 0; col < matrix.nbColumns(); ++col) {
+            if (obj.coefs[col] != 0.0)
+                terms.emplace_back(col, obj.coefs[col]);
+        }
+        if (terms.empty() && obj.quadratic.empty()) {
+            s_ << "\tdummy" << endl;
+        } else {
+            // The constant term does not change the optimal solutions
+            s_ << "\t";
+            writeLpTerms(terms, obj.quadratic.data(),
+                         obj.quadratic.data() + obj.quadratic.size(), true);
+            s_ << endl;
+        }
     } else {
         assert (m_.nbObjectives() == 0);
         s_ << "Maximize" << endl;
@@ -66,102 +83,151 @@ void ModelWriterLp::writeObjective() {
     }
 }
 
-void ModelWriterLp::writeConstraints() {
+void ModelWriterLp::writeConstraints(const LinearMatrix &matrix) {
     s_ << "Subject To" << endl;
-    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
-        const Model::ExpressionData &expr = m_.expression(i);
-        if (expr.op != UMO_OP_LINEARCOMP)
-            continue;
-        if (!m_.isConstraintPos(i))
+    for (uint32_t row = 0; row < matrix.nbRows(); ++row) {
+        int32_t indicator = matrix.rowIndicator(row);
+        if (indicator == LinearMatrix::InvalidIndex) {
+            writeLpRow(matrix, row, "");
             continue;
-        double lb = m_.value(expr.operands[0].var());
-        double ub = m_.value(expr.operands[1].var());
-        if (lb == ub && isfinite(lb)) {
-            s_ << "\t";
-            writeLpLinearExpression(i);
-            s_ << " = " << lb << endl;
-        } else {
-            if (isfinite(lb)) {
-                s_ << "\t";
-                writeLpLinearExpression(i);
-                s_ << " >= " << lb << endl;
-            }
-            if (isfinite(ub)) {
-                s_ << "\t";
-                writeLpLinearExpression(i);
-                s_ << " <= " << ub << endl;
-            }
         }
+        variableSeen_[indicator] = true;
+        stringstream condition;
+        condition << varName(indicator) << " = "
+                  << (matrix.rowIndicatorValue(row) ? 1 : 0) << " -> ";
+        writeLpRow(matrix, row, condition.str());
     }
     // GLPK crashes if the constraint section is empty or if there is no objective
     s_ << "\tdummy = 0" << endl;
 }
 
-void ModelWriterLp::writeBounds() {
-    s_ << "Bounds" << endl;
-    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
-        const Model::ExpressionData &expr = m_.expression(i);
-        if (expr.op == UMO_OP_DEC_BOOL && !variableSeen_[i]) {
-            // Scip crashes if a binary variable is not referenced before the Binary section
-            s_ << "\t0 <= " << varName(i) << " <= 1" << endl;
+void ModelWriterLp::writeLpRow(const LinearMatrix &matrix, uint32_t row,
+                               const string &condition) {
+    vector<pair<uint32_t, double>> terms;
+    for (uint32_t k = matrix.rowStart()[row]; k < matrix.rowStart()[row + 1];
+         ++k) {
+        terms.emplace_back(matrix.rowIndex()[k], matrix.rowValue()[k]);
+    }
+    const LinearMatrix::QuadraticTerm *quad = matrix.quadTerms().data();
+    const LinearMatrix::QuadraticTerm *beginQuad =
+        quad + matrix.quadStart()[row];
+    const LinearMatrix::QuadraticTerm *endQuad =
+        quad + matrix.quadStart()[row + 1];
+    double lb = matrix.rowLb(row);
+    double ub = matrix.rowUb(row);
+    if (lb == ub && isfinite(lb)) {
+        s_ << "\t" << condition;
+        writeLpTerms(terms, beginQuad, endQuad, false);
+        s_ << " = " << lb << endl;
+    } else {
+        if (isfinite(lb)) {
+            s_ << "\t" << condition;
+            writeLpTerms(terms, beginQuad, endQuad, false);
+            s_ << " >= " << lb << endl;
         }
-        if (expr.op == UMO_OP_DEC_INT || expr.op == UMO_OP_DEC_FLOAT) {
-            double lb = m_.value(expr.operands[0].var());
-            double ub = m_.value(expr.operands[1].var());
-            s_ << "\t";
-            if (std::isfinite(lb)) {
-                s_ << lb;
-            }
-            else {
-                if (!(lb < 0)) {
-                    throw std::runtime_error("Infinite lower bound should be negative");
-                }
-                s_ << "-inf";
+        if (isfinite(ub)) {
+            s_ << "\t" << condition;
+            writeLpTerms(terms, beginQuad, endQuad, false);
+            s_ << " <= " << ub << endl;
+        }
+    }
+}
+
+bool ModelWriterLp::isIndicator(uint32_t i) const {
+    const Model::ExpressionData &expr = m_.expression(i);
+    if (expr.op != UMO_OP_OR || expr.operands.size() != 2)
+        return false;
+    if (!m_.isConstraintPos(i) || m_.isConstraintNeg(i))
+        return false;
+    ExpressionId lit = expr.operands[0];
+    ExpressionId row = expr.operands[1];
+    return m_.expression(lit.var()).op == UMO_OP_DEC_BOOL && !lit.isMinus() &&
+           m_.expression(row.var()).op == UMO_OP_LINEARCOMP &&
+           !row.isNot() && !row.isMinus() && !m_.isConstraint(row.var());
+}
+
+bool ModelWriterLp::isQuadratic(ExpressionId id) const {
+    const Model::ExpressionData &expr = m_.expression(id.var());
+    if (expr.op != UMO_OP_PROD || id.isNot() || m_.isConstraint(id.var()))
+        return false;
+    int nbVariables = 0;
+    for (ExpressionId op : expr.operands) {
+        umo_operator operandOp = m_.expression(op.var()).op;
+        if (operandOp == UMO_OP_CONSTANT)
+            continue;
+        if (!Operator::get(operandOp).isDecision() || op.isNot())
+            return false;
+        ++nbVariables;
+    }
+    return nbVariables == 2;
+}
+
+void ModelWriterLp::writeBounds(const LinearMatrix &matrix) {
+    s_ << "Bounds" << endl;
+    for (uint32_t col = 0; col < matrix.nbColumns(); ++col) {
+        if (matrix.colType(col) == UMO_TYPE_BOOL) {
+            if (!variableSeen_[col]) {
+                // Scip crashes if a binary variable is not referenced before the Binary section
+                s_ << "\t0 <= " << varName(col) << " <= 1" << endl;
             }
-            s_ << " <= " << varName(i) << " <= ";
-            if (std::isfinite(ub)) {
-                s_ << ub << endl;
+            continue;
+        }
+        double lb = matrix.colLb(col);
+        double ub = matrix.colUb(col);
+        s_ << "\t";
+        if (std::isfinite(lb)) {
+            s_ << lb;
+        }
+        else {
+            if (!(lb < 0)) {
+                throw std::runtime_error("Infinite lower bound should be negative");
             }
-            else {
-                if (!(ub > 0)) {
-                    throw std::runtime_error("Infinite upper bound should be positive");
-                }
-                s_ << "+inf" << endl;
+            s_ << "-inf";
+        }
+        s_ << " <= " << varName(col) << " <= ";
+        if (std::isfinite(ub)) {
+            s_ << ub << endl;
+        }
+        else {
+            if (!(ub > 0)) {
+                throw std::runtime_error("Infinite upper bound should be positive");
             }
+            s_ << "+inf" << endl;
         }
     }
 }
 
-void ModelWriterLp::writeIntegers() {
+void ModelWriterLp::writeIntegers(const LinearMatrix &matrix) {
     bool binaryFound = false;
-    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
-        if (m_.expression(i).op == UMO_OP_DEC_BOOL) {
+    for (uint32_t col = 0; col < matrix.nbColumns(); ++col) {
+        if (matrix.colType(col) == UMO_TYPE_BOOL) {
             if (!binaryFound) {
                 binaryFound = true;
                 s_ << "Binary" << endl;
             }
-            s_ << "\t" << varName(i) << endl;
+            s_ << "\t" << varName(col) << endl;
         }
     }
     bool integerFound = false;
-    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
-        if (m_.expression(i).op == UMO_OP_DEC_INT) {
+    for (uint32_t col = 0; col < matrix.nbColumns(); ++col) {
+        if (matrix.colType(col) == UMO_TYPE_INT) {
             if (!integerFound) {
                 integerFound = true;
                 s_ << "General" << endl;
             }
-            s_ << "\t" << varName(i) << endl;
+            s_ << "\t" << varName(col) << endl;
         }
     }
 }
 
 void ModelWriterLp::write() {
     check();
-    initVarToId();
-    writeObjective();
-    writeConstraints();
-    writeBounds();
-    writeIntegers();
+    LinearMatrix matrix(m_);
+    variableSeen_.assign(matrix.nbColumns(), 0);
+    writeObjective(matrix);
+    writeConstraints(matrix);
+    writeBounds(matrix);
+    writeIntegers(matrix);
     s_ << "End" << endl;
 }
 
@@ -180,31 +246,10 @@ vector<int32_t> ModelWriterLp::getVarToId(const Model &m) {
     return varToId;
 }
 
-void ModelWriterLp::initVarToId() {
-    varToId_ = getVarToId(m_);
-    variableSeen_ = vector<char>(m_.nbExpressions(), 0);
-}
-
-string ModelWriterLp::varName(uint32_t i) const {
-    if (varToId_[i] == InvalidId) {
-        THROW_ERROR("Expression " << i << " (operator " << m_.expression(i).op
-                                  << ") hasn't been assigned a name");
-    }
-    stringstream s;
-    s << "x" << varToId_[i];
-    return s.str();
-}
-
-string ModelWriterLp::exprName(ExpressionId id) const {
+string ModelWriterLp::varName(uint32_t col) const {
+    // Columns follow the order of getVarToId()
     stringstream s;
-    s << (id.isMinus() ? "-" : "");
-    s << (id.isNot() ? "!" : "");
-    umo_operator operandOp = m_.expression(id.var()).op;
-    if (operandOp == UMO_OP_CONSTANT) {
-        s << m_.value(id.var());
-    } else {
-        s << "x" << varToId_[id.var()];
-    }
+    s << "x" << col;
     return s.str();
 }
 
@@ -213,6 +258,12 @@ void ModelWriterLp::check() const {
         THROW_ERROR(
             "Multiple objectives are not supported by the LP file writer");
     }
+    // Rows enforced by indicator constraints
+    vector<char> indicatorRow(m_.nbExpressions());
+    for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
+        if (isIndicator(i))
+            indicatorRow[m_.expression(i).operands[1].var()] = true;
+    }
     for (uint32_t i = 0; i < m_.nbExpressions(); ++i) {
         const Model::ExpressionData &expr = m_.expression(i);
         umo_operator op = expr.op;
@@ -228,45 +279,101 @@ void ModelWriterLp::check() const {
             }
             continue;
         }
+        if (op == UMO_OP_OR && isIndicator(i))
+            continue;
+        if (op == UMO_OP_PROD && isQuadratic(ExpressionId::fromVar(i)))
+            continue;
         if (op == UMO_OP_LINEARCOMP) {
-            if (m_.isConstraintNeg(i) || !m_.isConstraintPos(i)) {
+            bool enforced = indicatorRow[i] && !m_.isConstraint(i);
+            if (!enforced &&
+                (m_.isConstraintNeg(i) || !m_.isConstraintPos(i))) {
                 THROW_ERROR("All comparisons must be constraints for the LP "
                             "file writer");
             }
             for (uint32_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
                 umo_operator operandOp =
                     m_.getExpressionIdOp(expr.operands[2 * j + 1]);
-                if (!Operator::get(operandOp).isDecision()) {
+                if (!Operator::get(operandOp).isDecision() &&
+                    !isQuadratic(expr.operands[2 * j + 1])) {
                     THROW_ERROR("All operands of linear constraints must be "
                                 "decision variables for the LP file writer");
                 }
             }
             continue;
         }
+        if (op == UMO_OP_LINEAR && m_.isObjective(i)) {
+            for (uint32_t j = 0; 2 * j + 1 < expr.operands.size(); ++j) {
+                umo_operator operandOp =
+                    m_.getExpressionIdOp(expr.operands[2 * j + 1]);
+                if (operandOp != UMO_OP_CONSTANT &&
+                    !Operator::get(operandOp).isDecision() &&
+                    !isQuadratic(expr.operands[2 * j + 1])) {
+                    THROW_ERROR("All operands of linear objectives must be "
+                                "decision variables for the LP file writer");
+                }
+            }
+            continue;
+        }
+        if (op == UMO_OP_LINEAR && !m_.isConstraint(i)) {
+            // Definition of a variable eliminated during presolve; not
+            // written but used to recover its value
+            continue;
+        }
         THROW_ERROR("Operator " << op
                                 << " is not handled by the LP file writer");
     }
 }
 
-void ModelWriterLp::writeLpLinearExpression(uint32_t i) {
-    const Model::ExpressionData &expr = m_.expression(i);
+void ModelWriterLp::writeLpTerms(const vector<pair<uint32_t, double>> &terms,
+                                 const LinearMatrix::QuadraticTerm *beginQuad,
+                                 const LinearMatrix::QuadraticTerm *endQuad,
+                                 bool objective) {
     stringstream s;
-    for (uint32_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
-        double val = m_.value(expr.operands[2 * j].var());
-        ExpressionId id = expr.operands[2 * j + 1];
-        variableSeen_[id.var()] = true;
-        if (j > 1) {
+    bool firstTerm = true;
+    for (const auto &term : terms) {
+        double val = term.second;
+        variableSeen_[term.first] = true;
+        if (!firstTerm) {
             s << (val >= 0.0 ? " + " : " - ");
         } else {
             s << (val >= 0.0 ? " " : "- ");
         }
-        s << abs(val) << " " << varName(id.var());
+        firstTerm = false;
+        s << abs(val) << " " << varName(term.first);
         if (s.str().size() > maxLineLength - 20) {
             // Enforce a small-enough line length
             s_ << s.str() << endl;
             s.str("");
         }
     }
+    if (beginQuad != endQuad) {
+        // The quadratic part of the objective is halved by the LP format
+        double factor = objective ? 2.0 : 1.0;
+        s << (firstTerm ? " [" : " + [");
+        for (const LinearMatrix::QuadraticTerm *q = beginQuad; q != endQuad;
+             ++q) {
+            double val = factor * q->coef;
+            if (q != beginQuad) {
+                s << (val >= 0.0 ? " + " : " - ");
+            } else {
+                s << (val >= 0.0 ? " " : " - ");
+            }
+            variableSeen_[q->col1] = true;
+            variableSeen_[q->col2] = true;
+            s << abs(val) << " " << varName(q->col1);
+            if (q->col1 == q->col2)
+                s << " ^ 2";
+            else
+                s << " * " << varName(q->col2);
+            if (s.str().size() > maxLineLength - 20) {
+                s_ << s.str() << endl;
+                s.str("");
+            }
+        }
+        s << " ]";
+        if (objective)
+            s << " / 2";
+    }
     s_ << s.str();
 }
 
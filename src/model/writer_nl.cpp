@@ -1,4 +1,5 @@
 
+#include "model/linear_matrix.hpp"
 #include "model/model.hpp"
 #include "model/operator.hpp"
 #include "utils/utils.hpp"
@@ -41,11 +42,13 @@ class ModelWriterNl {
     void writeVariableBounds(); // "b" lines
     void writeJacobianSize(); // "k" lines
     void writeLinearConstraints(); // "J" lines
+    void writeLinearObjectives(); // "G" lines
 
-    // TODO: write linear constraint
     void writeExpressionGraph(ExpressionId id);
-    void writeLinearExpression(ExpressionId id);
     void writeBounds(double lb, double ub);
+    // Coefficients of a linear objective by variable id
+    vector<pair<int32_t, double>>
+    linearObjective(const LinearMatrix::Objective &obj) const;
 
   private:
     void initUmoToNl();
@@ -58,6 +61,7 @@ class ModelWriterNl {
   private:
     const Model &m_;
     ostream &s_;
+    LinearMatrix matrix_;
     vector<int> umoToNlOp_;
     vector<int32_t> varToId_;
 
@@ -70,14 +74,25 @@ class ModelWriterNl {
 constexpr int ModelWriterNl::InvalidOp;
 constexpr int32_t ModelWriterNl::InvalidId;
 
-ModelWriterNl::ModelWriterNl(const Model &m, ostream &s) : m_(m), s_(s) {}
+ModelWriterNl::ModelWriterNl(const Model &m, ostream &s)
+    : m_(m), s_(s), matrix_(m) {
+    for (uint32_t row = 0; row < matrix_.nbRows(); ++row) {
+        if (matrix_.rowIndicator(row) != LinearMatrix::InvalidIndex) {
+            THROW_ERROR(
+                "Cannot export indicator constraints in NL file writer");
+        }
+    }
+    if (!matrix_.quadTerms().empty()) {
+        THROW_ERROR("Cannot export quadratic constraints in NL file writer");
+    }
+}
 
 int ModelWriterNl::countVariables() const {
     return boolVariables_.size() + intVariables_.size() + floatVariables_.size();
 }
 
 int ModelWriterNl::countConstraints() const {
-    return m_.nbConstraints();
+    return matrix_.nbRows();
 }
 
 int ModelWriterNl::countObjectives() const {
@@ -90,7 +105,27 @@ int ModelWriterNl::countJacobianNonZeros() const {
 }
 
 int ModelWriterNl::countGradientNonZeros() const {
-    return 0;
+    int ret = 0;
+    for (const LinearMatrix::Objective &obj : matrix_.objectives()) {
+        if (obj.linear)
+            ret += linearObjective(obj).size();
+    }
+    return ret;
+}
+
+vector<pair<int32_t, double>>
+ModelWriterNl::linearObjective(const LinearMatrix::Objective &obj) const {
+    if (!obj.quadratic.empty()) {
+        THROW_ERROR("Cannot export quadratic objectives in NL file writer");
+    }
+    vector<pair<int32_t, double>> ret;
+    for (uint32_t col = 0; col < matrix_.nbColumns(); ++col) {
+        if (obj.coefs[col] != 0.0)
+            ret.emplace_back(varToId_[matrix_.colExpr(col)], obj.coefs[col]);
+    }
+    // Gradient entries are sorted by variable
+    sort(ret.begin(), ret.end());
+    return ret;
 }
 
 void ModelWriterNl::initBoolVariables() {
@@ -250,17 +285,10 @@ void ModelWriterNl::initUmoToNlId() {
 
 void ModelWriterNl::initJacobianSize() {
     jacobianSize_.assign(countVariables(), 0);
-    for (ExpressionId id : m_.constraints()) {
-        umo_operator op = m_.getExpressionIdOp(id);
-        if (op != UMO_OP_LINEARCOMP) {
-            THROW_ERROR("Cannot export nonlinear constraints yet in NL file writer");
-        }
-        const Model::ExpressionData &expr = m_.expression(id.var());
-        for (uint32_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
-            ExpressionId id = expr.operands[2 * j + 1];
-            uint32_t ind = varToId_.at(id.var());
-            ++jacobianSize_[ind];
-        }
+    for (uint32_t col = 0; col < matrix_.nbColumns(); ++col) {
+        uint32_t ind = varToId_.at(matrix_.colExpr(col));
+        jacobianSize_[ind] = matrix_.colStart()[col + 1] -
+                             matrix_.colStart()[col];
     }
     int totSize = 0;
     for (size_t i = 0; i < jacobianSize_.size(); ++i) {
@@ -298,11 +326,15 @@ void ModelWriterNl::writeHeader() {
 }
 
 void ModelWriterNl::writeObjectives() {
-    for (uint32_t i = 0; i < m_.nbObjectives(); ++i) {
-        ExpressionId obj = m_.objective(i).first;
-        bool maximize = m_.objective(0).second == UMO_OBJ_MAXIMIZE;
-        s_ << "O" << i << " " << (maximize ? "1" : "0") << endl;
-        writeExpressionGraph(obj);
+    for (uint32_t i = 0; i < matrix_.objectives().size(); ++i) {
+        const LinearMatrix::Objective &obj = matrix_.objectives()[i];
+        s_ << "O" << i << " " << (obj.maximize ? "1" : "0") << endl;
+        if (obj.linear) {
+            // Only the constant part is nonlinear; the terms are in "G" lines
+            s_ << "n" << obj.offset << endl;
+        } else {
+            writeExpressionGraph(obj.expr);
+        }
     }
     if (m_.nbObjectives() == 0) {
         // Dummy objective
@@ -310,62 +342,45 @@ void ModelWriterNl::writeObjectives() {
     }
 }
 
-void ModelWriterNl::writeLinearExpression(ExpressionId id) {
-    umo_operator op = m_.getExpressionIdOp(id);
-    assert (op == UMO_OP_LINEARCOMP);
-    const Model::ExpressionData &expr = m_.expression(id.var());
-    s_ << (expr.operands.size() - 2) / 2 << endl;
-    for (uint32_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
-        double val = m_.value(expr.operands[2 * j].var());
-        ExpressionId id = expr.operands[2 * j + 1];
-        uint32_t ind = varToId_.at(id.var());
-        if (ind == InvalidId) {
-            THROW_ERROR("Cannot export linear constraints on non-leaf expressions in NL file writer");
-        }
-        s_ << ind << " " << val << endl;
-    }
-}
-
 void ModelWriterNl::writeNonLinearConstraints() {
-    if (m_.constraints().empty()) return;
-    uint32_t i = 0;
-    for (ExpressionId id : m_.constraints()) {
-        umo_operator op = m_.getExpressionIdOp(id);
-        if (op != UMO_OP_LINEARCOMP) {
-            THROW_ERROR("Cannot export nonlinear constraints yet in NL file writer");
-        }
-        s_ << "C" << i << endl;
+    for (uint32_t row = 0; row < matrix_.nbRows(); ++row) {
+        s_ << "C" << row << endl;
         s_ << "n0" << endl;
-        ++i;
     }
 }
 
 void ModelWriterNl::writeConstraintBounds() {
     if (countConstraints() == 0) return;
     s_ << "r" << endl;
-    for (ExpressionId id : m_.constraints()) {
-        umo_operator op = m_.getExpressionIdOp(id);
-        if (op != UMO_OP_LINEARCOMP) {
-            THROW_ERROR("Cannot export nonlinear constraints yet in NL file writer");
-        }
-        const Model::ExpressionData &expr = m_.expression(id.var());
-        double lb = m_.value(expr.operands[0].var());
-        double ub = m_.value(expr.operands[1].var());
-        writeBounds(lb, ub);
+    for (uint32_t row = 0; row < matrix_.nbRows(); ++row) {
+        writeBounds(matrix_.rowLb(row), matrix_.rowUb(row));
     }
 }
 
 void ModelWriterNl::writeLinearConstraints() {
-    if (countConstraints() == 0) return;
-    uint32_t i = 0;
-    for (ExpressionId id : m_.constraints()) {
-        umo_operator op = m_.getExpressionIdOp(id);
-        if (op != UMO_OP_LINEARCOMP) {
-            THROW_ERROR("Cannot export nonlinear constraints yet in NL file writer");
+    const vector<uint32_t> &rowStart = matrix_.rowStart();
+    for (uint32_t row = 0; row < matrix_.nbRows(); ++row) {
+        s_ << "J" << row << " " << rowStart[row + 1] - rowStart[row] << endl;
+        for (uint32_t k = rowStart[row]; k < rowStart[row + 1]; ++k) {
+            uint32_t col = matrix_.rowIndex()[k];
+            s_ << varToId_.at(matrix_.colExpr(col)) << " "
+               << matrix_.rowValue()[k] << endl;
+        }
+    }
+}
+
+void ModelWriterNl::writeLinearObjectives() {
+    for (uint32_t i = 0; i < matrix_.objectives().size(); ++i) {
+        const LinearMatrix::Objective &obj = matrix_.objectives()[i];
+        if (!obj.linear)
+            continue;
+        vector<pair<int32_t, double>> terms = linearObjective(obj);
+        if (terms.empty())
+            continue;
+        s_ << "G" << i << " " << terms.size() << endl;
+        for (const auto &term : terms) {
+            s_ << term.first << " " << term.second << endl;
         }
-        s_ << "J" << i << " ";
-        writeLinearExpression(id);
-        ++i;
     }
 }
 
@@ -432,6 +447,7 @@ void ModelWriterNl::write() {
     writeVariableBounds(); // "b" lines
     writeJacobianSize(); // "k" lines
     writeLinearConstraints(); // "J" lines
+    writeLinearObjectives(); // "G" lines
 }
 
 void Model::writeNl(ostream &os) const {
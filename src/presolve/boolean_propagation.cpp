@@ -0,0 +1,268 @@
+#include "presolve/boolean_propagation.hpp"
+
+#include "model/operator.hpp"
+#include "presolve/rewriter.hpp"
+
+#include <deque>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class BooleanPropagation::Propagator {
+  public:
+    Propagator(const PresolvedModel &model);
+    bool run();
+    // Whether the propagation decided new nodes
+    bool decided() const;
+    void rewrite(Rewriter &rewriter) const;
+
+  private:
+    static bool isGate(umo_operator op) {
+        return op == UMO_OP_AND || op == UMO_OP_OR || op == UMO_OP_XOR;
+    }
+
+    // Value of a literal: 0, 1, or -1 if unknown
+    int value(ExpressionId lit) const {
+        int val = values_[lit.var()];
+        return val < 0 ? val : val ^ (int)lit.isNot();
+    }
+    void assign(ExpressionId lit, bool val);
+
+    void propagate(uint32_t i);
+    // AND, or OR as the negation of an AND of the negated operands
+    void propagateAnd(uint32_t i, bool negated);
+    void propagateXor(uint32_t i);
+
+    // Expression of the new model for a gate, without its decided operands
+    ExpressionId simplifyGate(Rewriter &rewriter, uint32_t i) const;
+
+  private:
+    const PresolvedModel &model_;
+    // Value of each expression, or -1 if unknown
+    vector<signed char> values_;
+    // AND/OR/XOR nodes using each expression
+    vector<vector<uint32_t>> parents_;
+    // Expressions that are constraints
+    vector<char> roots_;
+    deque<uint32_t> queue_;
+    bool conflict_;
+};
+
+BooleanPropagation::Propagator::Propagator(const PresolvedModel &model)
+    : model_(model), values_(model.nbExpressions(), -1),
+      parents_(model.nbExpressions()), roots_(model.nbExpressions()),
+      conflict_(false) {
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        if (expr.op == UMO_OP_CONSTANT && expr.type == UMO_TYPE_BOOL) {
+            values_[i] = model.value(i) == 1.0;
+        } else if (isGate(expr.op)) {
+            for (ExpressionId op : expr.operands) {
+                parents_[op.var()].push_back(i);
+            }
+        }
+    }
+}
+
+void BooleanPropagation::Propagator::assign(ExpressionId lit, bool val) {
+    uint32_t i = lit.var();
+    int varVal = (int)val ^ (int)lit.isNot();
+    if (values_[i] == varVal)
+        return;
+    if (values_[i] >= 0) {
+        conflict_ = true;
+        return;
+    }
+    values_[i] = varVal;
+    queue_.push_back(i);
+}
+
+bool BooleanPropagation::Propagator::run() {
+    for (ExpressionId c : model_.constraints()) {
+        if (model_.expression(c.var()).type != UMO_TYPE_BOOL)
+            continue;
+        if (c.isVar())
+            roots_[c.var()] = true;
+        assign(c, true);
+    }
+    // Gates with constant operands
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        propagate(i);
+    }
+    while (!queue_.empty() && !conflict_) {
+        uint32_t i = queue_.front();
+        queue_.pop_front();
+        propagate(i);
+        for (uint32_t p : parents_[i]) {
+            propagate(p);
+        }
+    }
+    return !conflict_;
+}
+
+void BooleanPropagation::Propagator::propagate(uint32_t i) {
+    switch (model_.expression(i).op) {
+    case UMO_OP_AND:
+        propagateAnd(i, false);
+        break;
+    case UMO_OP_OR:
+        propagateAnd(i, true);
+        break;
+    case UMO_OP_XOR:
+        propagateXor(i);
+        break;
+    default:
+        break;
+    }
+}
+
+void BooleanPropagation::Propagator::propagateAnd(uint32_t i, bool negated) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    // Negate the node and the operands for an OR
+    ExpressionId node = ExpressionId(i, negated, false);
+    bool anyFalse = false;
+    int nbUnknown = 0;
+    ExpressionId unknown;
+    for (ExpressionId op : expr.operands) {
+        ExpressionId lit = negated ? op.getNot() : op;
+        int val = value(lit);
+        if (val == 0) {
+            anyFalse = true;
+        } else if (val < 0) {
+            ++nbUnknown;
+            unknown = lit;
+        }
+    }
+    if (anyFalse)
+        assign(node, false);
+    else if (nbUnknown == 0)
+        assign(node, true);
+    int nodeVal = value(node);
+    if (nodeVal == 1) {
+        for (ExpressionId op : expr.operands) {
+            assign(negated ? op.getNot() : op, true);
+        }
+    } else if (nodeVal == 0 && !anyFalse && nbUnknown == 1) {
+        // All other operands are true
+        assign(unknown, false);
+    }
+}
+
+void BooleanPropagation::Propagator::propagateXor(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    ExpressionId node = ExpressionId::fromVar(i);
+    bool parity = false;
+    int nbUnknown = 0;
+    ExpressionId unknown;
+    for (ExpressionId op : expr.operands) {
+        int val = value(op);
+        if (val < 0) {
+            ++nbUnknown;
+            unknown = op;
+        } else {
+            parity ^= val == 1;
+        }
+    }
+    if (nbUnknown == 0)
+        assign(node, parity);
+    int nodeVal = value(node);
+    if (nodeVal >= 0 && nbUnknown == 1)
+        assign(unknown, (nodeVal == 1) ^ parity);
+}
+
+void BooleanPropagation::Propagator::rewrite(Rewriter &rewriter) const {
+    PresolvedModel &newModel = rewriter.newModel();
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (expr.op == UMO_OP_CONSTANT || expr.op == UMO_OP_INVALID)
+            continue;
+        bool isDecided = values_[i] >= 0;
+        if (isDecided && Operator::get(expr.op).isDecision()) {
+            rewriter.replace(i, newModel.createConstant(values_[i]));
+            continue;
+        }
+        ExpressionId newId;
+        if (isGate(expr.op)) {
+            newId = simplifyGate(rewriter, i);
+        } else {
+            newId = rewriter.copy(i);
+        }
+        if (!isDecided) {
+            rewriter.replace(i, newId);
+            continue;
+        }
+        // The value of the node may come from its parents or from a
+        // constraint: enforce it on the simplified expression
+        if (!newModel.isConstant(newId.var()))
+            newModel.createConstraint(values_[i] ? newId : newId.getNot());
+        rewriter.replace(i, newModel.createConstant(values_[i]));
+    }
+}
+
+ExpressionId
+BooleanPropagation::Propagator::simplifyGate(Rewriter &rewriter,
+                                             uint32_t i) const {
+    const Model::ExpressionData &expr = model_.expression(i);
+    PresolvedModel &newModel = rewriter.newModel();
+    // Remove the decided operands: true ones are neutral for an AND, false
+    // ones for an OR, and they change the parity of a XOR
+    vector<ExpressionId> operands;
+    bool anyTrue = false;
+    bool anyFalse = false;
+    bool parity = false;
+    for (ExpressionId op : expr.operands) {
+        int val = value(op);
+        if (val < 0) {
+            operands.push_back(rewriter.get(op));
+        } else {
+            anyTrue |= val == 1;
+            anyFalse |= val == 0;
+            parity ^= val == 1;
+        }
+    }
+    if (operands.size() == expr.operands.size())
+        return rewriter.copy(i);
+    if (expr.op == UMO_OP_AND && anyFalse)
+        return newModel.createConstant(0.0);
+    if (expr.op == UMO_OP_OR && anyTrue)
+        return newModel.createConstant(1.0);
+    if (expr.op != UMO_OP_XOR)
+        parity = false;
+    if (operands.empty()) {
+        double val = expr.op == UMO_OP_AND ? 1.0 : parity;
+        return newModel.createConstant(val);
+    }
+    ExpressionId newId = operands.size() == 1
+                             ? operands[0]
+                             : newModel.createExpression(expr.op, operands);
+    return parity ? newId.getNot() : newId;
+}
+
+bool BooleanPropagation::Propagator::decided() const {
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        if (values_[i] < 0 || model_.isConstant(i))
+            continue;
+        // Constraints are already enforced
+        if (!roots_[i] || model_.isDecision(i))
+            return true;
+    }
+    return false;
+}
+
+void BooleanPropagation::run(PresolvedModel &model) const {
+    Propagator propagator(model);
+    if (!propagator.run()) {
+        model.setInfeasible();
+        return;
+    }
+    if (!propagator.decided())
+        return;
+    Rewriter rewriter(model);
+    propagator.rewrite(rewriter);
+    rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
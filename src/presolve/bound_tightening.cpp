@@ -0,0 +1,452 @@
+#include "presolve/bound_tightening.hpp"
+
+#include "model/operator.hpp"
+#include "presolve/rewriter.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class BoundTightening::Propagator {
+  public:
+    Propagator(const PresolvedModel &model);
+    bool run();
+
+    const vector<Interval> &bounds() const { return bounds_; }
+
+    void forward(uint32_t i);
+    void backward(uint32_t i);
+
+    void backwardProd(uint32_t i);
+    void backwardLinear(const vector<double> &coefs,
+                        const vector<ExpressionId> &operands, Interval target);
+    void backwardCompare(uint32_t i);
+    void backwardAnd(uint32_t i);
+    void backwardOr(uint32_t i);
+    void backwardXor(uint32_t i);
+    void backwardMin(uint32_t i);
+    void backwardMax(uint32_t i);
+
+    // Helper function: bounds of a compressed (not/minus) expression
+    Interval get(ExpressionId id) const;
+    // Helper function: tighten the bounds of a compressed expression
+    void tighten(ExpressionId id, Interval bounds);
+    // Helper function: is the new bound a significant improvement
+    bool improves(double oldBound, double newBound) const;
+
+  private:
+    const PresolvedModel &model_;
+    vector<Interval> bounds_;
+    bool changed_;
+    bool infeasible_;
+
+    const int maxRounds = 20;
+    const double tolerance = 1.0e-6;
+};
+
+BoundTightening::Propagator::Propagator(const PresolvedModel &model)
+    : model_(model), changed_(false), infeasible_(false) {
+    bounds_.resize(model.nbExpressions());
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        if (expr.op == UMO_OP_CONSTANT)
+            bounds_[i] = Interval(model.value(i));
+        else if (expr.type == UMO_TYPE_BOOL)
+            bounds_[i] = Interval::boolean();
+    }
+}
+
+bool BoundTightening::Propagator::run() {
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        forward(i);
+    }
+    for (ExpressionId c : model_.constraints()) {
+        tighten(c, Interval(1.0));
+    }
+    for (int round = 0; round < maxRounds && !infeasible_; ++round) {
+        changed_ = false;
+        for (uint32_t i = model_.nbExpressions(); i > 0; --i) {
+            backward(i - 1);
+        }
+        for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+            forward(i);
+        }
+        if (!changed_)
+            break;
+    }
+    return !infeasible_;
+}
+
+Interval BoundTightening::Propagator::get(ExpressionId id) const {
+    Interval bounds = bounds_[id.var()];
+    if (id.isNot())
+        bounds = Interval(1.0 - bounds.ub, 1.0 - bounds.lb);
+    if (id.isMinus())
+        bounds = -bounds;
+    return bounds;
+}
+
+bool BoundTightening::Propagator::improves(double oldBound,
+                                           double newBound) const {
+    if (!std::isfinite(oldBound))
+        return std::isfinite(newBound);
+    return std::abs(newBound - oldBound) >
+           tolerance * std::max(1.0, std::abs(oldBound));
+}
+
+void BoundTightening::Propagator::tighten(ExpressionId id, Interval bounds) {
+    if (infeasible_)
+        return;
+    if (std::isnan(bounds.lb) || std::isnan(bounds.ub))
+        return;
+    if (id.isMinus())
+        bounds = -bounds;
+    if (id.isNot())
+        bounds = Interval(1.0 - bounds.ub, 1.0 - bounds.lb);
+    uint32_t i = id.var();
+    umo_type type = model_.expression(i).type;
+    if (type != UMO_TYPE_FLOAT)
+        bounds = bounds.roundInward();
+    Interval &cur = bounds_[i];
+    Interval tightened = cur.intersect(bounds);
+    if (tightened.empty()) {
+        double gap = tightened.lb - tightened.ub;
+        double magnitude = std::max(std::abs(tightened.lb), std::abs(tightened.ub));
+        if (type == UMO_TYPE_FLOAT && gap <= tolerance * std::max(1.0, magnitude)) {
+            // Numerical noise: collapse to a single value
+            tightened = Interval(0.5 * (tightened.lb + tightened.ub));
+        } else {
+            infeasible_ = true;
+            return;
+        }
+    }
+    if (improves(cur.lb, tightened.lb) || improves(cur.ub, tightened.ub))
+        changed_ = true;
+    cur = tightened;
+}
+
+void BoundTightening::Propagator::forward(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    if (expr.op == UMO_OP_CONSTANT || expr.op == UMO_OP_INVALID)
+        return;
+    vector<Interval> operands;
+    operands.reserve(expr.operands.size());
+    for (ExpressionId id : expr.operands) {
+        operands.push_back(get(id));
+    }
+    Interval bounds = Operator::get(expr.op).computeBounds(operands.size(),
+                                                           operands.data());
+    tighten(ExpressionId::fromVar(i), bounds);
+}
+
+void BoundTightening::Propagator::backward(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    switch (expr.op) {
+    case UMO_OP_SUM:
+        backwardLinear(vector<double>(expr.operands.size(), 1.0), expr.operands,
+                       bounds_[i]);
+        break;
+    case UMO_OP_PROD:
+        backwardProd(i);
+        break;
+    case UMO_OP_LINEAR:
+    case UMO_OP_LINEARCOMP: {
+        uint32_t first = expr.op == UMO_OP_LINEAR ? 0 : 1;
+        vector<double> coefs;
+        vector<ExpressionId> operands;
+        for (uint32_t j = first; 2 * j + 1 < expr.operands.size(); ++j) {
+            coefs.push_back(model_.getExpressionIdValue(expr.operands[2 * j]));
+            operands.push_back(expr.operands[2 * j + 1]);
+        }
+        if (expr.op == UMO_OP_LINEAR) {
+            backwardLinear(coefs, operands, bounds_[i]);
+        } else if (bounds_[i].lb == 1.0) {
+            Interval target(get(expr.operands[0]).lb, get(expr.operands[1]).ub);
+            backwardLinear(coefs, operands, target);
+        }
+        break;
+    }
+    case UMO_OP_CMP_EQ:
+    case UMO_OP_CMP_NEQ:
+    case UMO_OP_CMP_LEQ:
+    case UMO_OP_CMP_GEQ:
+    case UMO_OP_CMP_LT:
+    case UMO_OP_CMP_GT:
+        backwardCompare(i);
+        break;
+    case UMO_OP_AND:
+        backwardAnd(i);
+        break;
+    case UMO_OP_OR:
+        backwardOr(i);
+        break;
+    case UMO_OP_XOR:
+        backwardXor(i);
+        break;
+    case UMO_OP_MIN:
+        backwardMin(i);
+        break;
+    case UMO_OP_MAX:
+        backwardMax(i);
+        break;
+    default:
+        break;
+    }
+}
+
+void BoundTightening::Propagator::backwardLinear(
+    const vector<double> &coefs, const vector<ExpressionId> &operands,
+    Interval target) {
+    if (!std::isfinite(target.lb) && !std::isfinite(target.ub))
+        return;
+    // Activity bounds, counting the infinite contributions separately
+    vector<Interval> terms;
+    terms.reserve(operands.size());
+    double minFinite = 0.0;
+    double maxFinite = 0.0;
+    int minInfinite = 0;
+    int maxInfinite = 0;
+    for (size_t j = 0; j < operands.size(); ++j) {
+        Interval term = Interval(coefs[j]) * get(operands[j]);
+        terms.push_back(term);
+        if (std::isfinite(term.lb))
+            minFinite += term.lb;
+        else
+            ++minInfinite;
+        if (std::isfinite(term.ub))
+            maxFinite += term.ub;
+        else
+            ++maxInfinite;
+    }
+    const double inf = numeric_limits<double>::infinity();
+    for (size_t j = 0; j < operands.size(); ++j) {
+        double coef = coefs[j];
+        if (coef == 0.0)
+            continue;
+        const Interval &term = terms[j];
+        bool termMinInfinite = !std::isfinite(term.lb);
+        bool termMaxInfinite = !std::isfinite(term.ub);
+        double othersMin = minInfinite - termMinInfinite > 0
+                               ? -inf
+                               : minFinite - (termMinInfinite ? 0.0 : term.lb);
+        double othersMax = maxInfinite - termMaxInfinite > 0
+                               ? inf
+                               : maxFinite - (termMaxInfinite ? 0.0 : term.ub);
+        Interval termBounds(target.lb - othersMax, target.ub - othersMin);
+        tighten(operands[j], termBounds / Interval(coef));
+    }
+}
+
+void BoundTightening::Propagator::backwardProd(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    if (bounds_[i] == Interval())
+        return;
+    size_t n = expr.operands.size();
+    // Product of the other operands, from prefix and suffix products
+    vector<Interval> suffix(n + 1, Interval(1.0));
+    for (size_t j = n; j > 0; --j) {
+        suffix[j - 1] = suffix[j] * get(expr.operands[j - 1]);
+    }
+    Interval prefix(1.0);
+    for (size_t j = 0; j < n; ++j) {
+        Interval others = prefix * suffix[j + 1];
+        if (!others.contains(0.0))
+            tighten(expr.operands[j], bounds_[i] / others);
+        prefix = prefix * get(expr.operands[j]);
+    }
+}
+
+void BoundTightening::Propagator::backwardCompare(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    const Interval &b = bounds_[i];
+    if (!b.isPoint())
+        return;
+    bool holds = b.lb == 1.0;
+    ExpressionId op1 = expr.operands[0];
+    ExpressionId op2 = expr.operands[1];
+    const double inf = numeric_limits<double>::infinity();
+    bool isEq = (expr.op == UMO_OP_CMP_EQ && holds) ||
+                (expr.op == UMO_OP_CMP_NEQ && !holds);
+    bool isLeq = ((expr.op == UMO_OP_CMP_LEQ || expr.op == UMO_OP_CMP_LT) &&
+                  holds) ||
+                 ((expr.op == UMO_OP_CMP_GEQ || expr.op == UMO_OP_CMP_GT) &&
+                  !holds);
+    bool isGeq = ((expr.op == UMO_OP_CMP_GEQ || expr.op == UMO_OP_CMP_GT) &&
+                  holds) ||
+                 ((expr.op == UMO_OP_CMP_LEQ || expr.op == UMO_OP_CMP_LT) &&
+                  !holds);
+    if (isEq) {
+        tighten(op1, get(op2));
+        tighten(op2, get(op1));
+    } else if (isLeq) {
+        tighten(op1, Interval(-inf, get(op2).ub));
+        tighten(op2, Interval(get(op1).lb, inf));
+    } else if (isGeq) {
+        tighten(op2, Interval(-inf, get(op1).ub));
+        tighten(op1, Interval(get(op2).lb, inf));
+    }
+}
+
+void BoundTightening::Propagator::backwardAnd(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    if (bounds_[i].lb == 1.0) {
+        for (ExpressionId op : expr.operands) {
+            tighten(op, Interval(1.0));
+        }
+    } else if (bounds_[i].ub == 0.0) {
+        // If all operands but one are true, the last one is false
+        ExpressionId free;
+        int nbFree = 0;
+        for (ExpressionId op : expr.operands) {
+            if (get(op).lb != 1.0) {
+                free = op;
+                ++nbFree;
+            }
+        }
+        if (nbFree == 1)
+            tighten(free, Interval(0.0));
+    }
+}
+
+void BoundTightening::Propagator::backwardOr(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    if (bounds_[i].ub == 0.0) {
+        for (ExpressionId op : expr.operands) {
+            tighten(op, Interval(0.0));
+        }
+    } else if (bounds_[i].lb == 1.0) {
+        // If all operands but one are false, the last one is true
+        ExpressionId free;
+        int nbFree = 0;
+        for (ExpressionId op : expr.operands) {
+            if (get(op).ub != 0.0) {
+                free = op;
+                ++nbFree;
+            }
+        }
+        if (nbFree == 1)
+            tighten(free, Interval(1.0));
+    }
+}
+
+void BoundTightening::Propagator::backwardXor(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    if (!bounds_[i].isPoint())
+        return;
+    // If all operands but one are fixed, the last one is determined
+    bool parity = bounds_[i].lb == 1.0;
+    ExpressionId free;
+    int nbFree = 0;
+    for (ExpressionId op : expr.operands) {
+        Interval b = get(op);
+        if (b.isPoint()) {
+            parity ^= (b.lb == 1.0);
+        } else {
+            free = op;
+            ++nbFree;
+        }
+    }
+    if (nbFree == 1)
+        tighten(free, Interval(parity ? 1.0 : 0.0));
+}
+
+void BoundTightening::Propagator::backwardMin(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    const Interval &b = bounds_[i];
+    const double inf = numeric_limits<double>::infinity();
+    // All operands are above the minimum; if only one can be below the upper
+    // bound, it is the minimum
+    ExpressionId candidate;
+    int nbCandidates = 0;
+    for (ExpressionId op : expr.operands) {
+        tighten(op, Interval(b.lb, inf));
+        if (get(op).lb <= b.ub) {
+            candidate = op;
+            ++nbCandidates;
+        }
+    }
+    if (nbCandidates == 1)
+        tighten(candidate, Interval(-inf, b.ub));
+}
+
+void BoundTightening::Propagator::backwardMax(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    const Interval &b = bounds_[i];
+    const double inf = numeric_limits<double>::infinity();
+    // All operands are below the maximum; if only one can be above the lower
+    // bound, it is the maximum
+    ExpressionId candidate;
+    int nbCandidates = 0;
+    for (ExpressionId op : expr.operands) {
+        tighten(op, Interval(-inf, b.ub));
+        if (get(op).ub >= b.lb) {
+            candidate = op;
+            ++nbCandidates;
+        }
+    }
+    if (nbCandidates == 1)
+        tighten(candidate, Interval(b.lb, inf));
+}
+
+bool BoundTightening::propagate(const PresolvedModel &model,
+                                vector<Interval> &bounds) const {
+    Propagator propagator(model);
+    bool feasible = propagator.run();
+    bounds = propagator.bounds();
+    return feasible;
+}
+
+void BoundTightening::extend(const PresolvedModel &model,
+                             vector<Interval> &bounds) const {
+    Propagator propagator(model);
+    uint32_t first = bounds.size();
+    for (uint32_t i = 0; i < first; ++i) {
+        propagator.tighten(ExpressionId::fromVar(i), bounds[i]);
+    }
+    for (uint32_t i = first; i < model.nbExpressions(); ++i) {
+        propagator.forward(i);
+    }
+    bounds = propagator.bounds();
+}
+
+void BoundTightening::run(PresolvedModel &model) const {
+    vector<Interval> bounds;
+    if (!propagate(model, bounds)) {
+        model.setInfeasible();
+        return;
+    }
+    // Write the new bounds of the decisions
+    const double tolerance = 1.0e-6;
+    Rewriter rewriter(model);
+    PresolvedModel &newModel = rewriter.newModel();
+    bool changed = false;
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        if (expr.op != UMO_OP_DEC_INT && expr.op != UMO_OP_DEC_FLOAT)
+            continue;
+        double lb = model.getExpressionIdValue(expr.operands[0]);
+        double ub = model.getExpressionIdValue(expr.operands[1]);
+        double newLb = bounds[i].lb;
+        double newUb = bounds[i].ub;
+        // Avoid rewriting continuous bounds for numerical noise
+        bool lbChanged = newLb > lb && (!std::isfinite(lb) ||
+                                        newLb - lb > tolerance * std::max(1.0, std::abs(lb)));
+        bool ubChanged = newUb < ub && (!std::isfinite(ub) ||
+                                        ub - newUb > tolerance * std::max(1.0, std::abs(ub)));
+        if (!lbChanged && !ubChanged)
+            continue;
+        ExpressionId lbId = newModel.createConstant(lbChanged ? newLb : lb);
+        ExpressionId ubId = newModel.createConstant(ubChanged ? newUb : ub);
+        rewriter.replace(i, newModel.createExpression(expr.op, {lbId, ubId}));
+        changed = true;
+    }
+    if (changed)
+        rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -0,0 +1,168 @@
+#include "presolve/cache.hpp"
+
+#include "utils/utils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+namespace {
+mutex cacheMutex;
+
+struct Entry {
+    // Serialized input, compared on a hit to rule out hash collisions
+    string input;
+    PresolvedModel result;
+};
+
+unordered_map<uint64_t, Entry> &memoryCache() {
+    static unordered_map<uint64_t, Entry> entries;
+    return entries;
+}
+
+string serialize(const PresolvedModel &model) {
+    stringstream ss;
+    model.save(ss);
+    return ss.str();
+}
+
+uint64_t hashString(const string &s) {
+    uint64_t ret = s.size();
+    for (char c : s) {
+        ret = hashCombine(ret, (unsigned char)c);
+    }
+    return ret;
+}
+} // namespace
+
+Cache::Cache(const Model &input, const string &stage) : input_(input) {
+    init(input, stage);
+    if (enabled_) {
+        key_ = hashCombine(key_, input.hash());
+        inputData_ = serialize(PresolvedModel(input));
+    }
+}
+
+Cache::Cache(const PresolvedModel &input, const string &stage)
+    : input_(input) {
+    init(input, stage);
+    if (enabled_) {
+        key_ = hashCombine(key_, input.hash());
+        inputData_ = serialize(input);
+    }
+}
+
+void Cache::init(const Model &input, const string &stage) {
+    const string &param = input.getStringParameter("presolve_cache");
+    if (param != "on" && param != "off")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid presolve_cache parameter");
+    enabled_ = param == "on";
+    key_ = hashString(stage);
+    directory_ = input.getStringParameter("presolve_cache_dir");
+}
+
+string Cache::filename() const {
+    if (directory_.empty())
+        return string();
+    stringstream fname;
+    fname << directory_;
+    if (directory_.back() != '/' && directory_.back() != '\\')
+        fname << "/";
+    fname << "umo_presolve_" << hex << setw(16) << setfill('0') << key_
+          << ".txt";
+    return fname.str();
+}
+
+bool Cache::find(PresolvedModel &result) const {
+    if (!enabled_)
+        return false;
+    // The result may be the input itself
+    Model params;
+    params.copyParameters(input_);
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = memoryCache().find(key_);
+        if (it != memoryCache().end() && it->second.input == inputData_) {
+            result = it->second.result;
+            result.copyParameters(params);
+            return true;
+        }
+    }
+    if (directory_.empty())
+        return false;
+    ifstream f(filename(), ios::binary);
+    if (!f)
+        return false;
+    // The file starts with the input it was computed from
+    size_t inputSize = 0;
+    f >> inputSize;
+    f.get();
+    if (!f || inputSize != inputData_.size())
+        return false;
+    string storedInput(inputSize, '\0');
+    f.read(&storedInput[0], inputSize);
+    if (!f || storedInput != inputData_)
+        return false;
+    try {
+        result.load(f);
+    } catch (runtime_error &) {
+        // Corrupted or incompatible entry: presolve again
+        return false;
+    }
+    result.copyParameters(params);
+    lock_guard<mutex> lock(cacheMutex);
+    Entry &entry = memoryCache()[key_];
+    entry.input = inputData_;
+    entry.result = result;
+    entry.result.setIncrementalState(nullptr);
+    return true;
+}
+
+void Cache::insert(const PresolvedModel &result) const {
+    if (!enabled_)
+        return;
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        Entry &entry = memoryCache()[key_];
+        entry.input = inputData_;
+        entry.result = result;
+        // The entry must not keep the state of the solved model alive
+        entry.result.setIncrementalState(nullptr);
+    }
+    if (directory_.empty())
+        return;
+    // Write to a temporary file first so that readers never see a partial
+    // entry
+    string fname = filename();
+    string tmpName = fname + ".tmp";
+    {
+        ofstream f(tmpName, ios::binary);
+        if (!f)
+            return;
+        f << inputData_.size() << "\n" << inputData_;
+        result.save(f);
+        if (!f) {
+            remove(tmpName.c_str());
+            return;
+        }
+    }
+    if (rename(tmpName.c_str(), fname.c_str()) != 0)
+        remove(tmpName.c_str());
+}
+
+void Cache::clear() {
+    lock_guard<mutex> lock(cacheMutex);
+    memoryCache().clear();
+}
+
+} // namespace presolve
+} // namespace umoi
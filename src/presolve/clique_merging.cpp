@@ -0,0 +1,144 @@
+#include "presolve/clique_merging.hpp"
+
+#include "presolve/linear_rows.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+namespace {
+// Literal of a binary variable: 2 * var, plus one for its complement
+typedef uint32_t Literal;
+
+uint64_t edgeKey(Literal a, Literal b) {
+    if (a > b)
+        swap(a, b);
+    return ((uint64_t)a << 32) | b;
+}
+
+// Literals whose conjunction is forbidden by a row over two binaries, if it
+// forbids exactly one assignment
+bool readConflict(const LinearRow &row, Literal &l1, Literal &l2) {
+    double tol = LinearRows::feasibilityTolerance;
+    int nbForbidden = 0;
+    for (int v1 = 0; v1 <= 1; ++v1) {
+        for (int v2 = 0; v2 <= 1; ++v2) {
+            double act = row.coefs[0] * v1 + row.coefs[1] * v2;
+            if (act <= row.ub + tol * max(1.0, abs(row.ub)) &&
+                act >= row.lb - tol * max(1.0, abs(row.lb)))
+                continue;
+            ++nbForbidden;
+            l1 = 2 * row.vars[0] + (v1 ? 0 : 1);
+            l2 = 2 * row.vars[1] + (v2 ? 0 : 1);
+        }
+    }
+    return nbForbidden == 1;
+}
+} // namespace
+
+void CliqueMerging::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    LinearRows linearRows(model);
+    vector<LinearRow> &rows = linearRows.rows();
+    const vector<Interval> &bounds = linearRows.bounds();
+    auto isBinary = [&](uint32_t var) {
+        return linearRows.isInteger(var) && bounds[var] == Interval::boolean();
+    };
+
+    // Conflict graph, with the row defining each edge
+    unordered_map<uint64_t, uint32_t> edges;
+    unordered_map<Literal, vector<Literal>> neighbours;
+    for (uint32_t r = 0; r < rows.size(); ++r) {
+        const LinearRow &row = rows[r];
+        if (row.removed || row.vars.size() != 2 || !isBinary(row.vars[0]) ||
+            !isBinary(row.vars[1]))
+            continue;
+        Literal l1, l2;
+        if (!readConflict(row, l1, l2))
+            continue;
+        if (!edges.emplace(edgeKey(l1, l2), r).second)
+            continue;
+        neighbours[l1].push_back(l2);
+        neighbours[l2].push_back(l1);
+    }
+
+    // Seeds by decreasing degree
+    vector<Literal> seeds;
+    for (const auto &n : neighbours) {
+        if (n.second.size() >= 2)
+            seeds.push_back(n.first);
+    }
+    auto byDegree = [&](Literal a, Literal b) {
+        size_t da = neighbours[a].size();
+        size_t db = neighbours[b].size();
+        return da != db ? da > db : a < b;
+    };
+    sort(seeds.begin(), seeds.end(), byDegree);
+
+    bool changed = false;
+    for (Literal seed : seeds) {
+        // Grow the clique greedily among the neighbours of the seed
+        vector<Literal> candidates = neighbours[seed];
+        sort(candidates.begin(), candidates.end(), byDegree);
+        vector<Literal> clique = {seed};
+        for (Literal c : candidates) {
+            // A literal and its complement cannot be in the same clique
+            bool adjacent = true;
+            for (Literal l : clique) {
+                if ((l ^ 1) == c || !edges.count(edgeKey(l, c))) {
+                    adjacent = false;
+                    break;
+                }
+            }
+            if (adjacent)
+                clique.push_back(c);
+        }
+        if (clique.size() < 3)
+            continue;
+        // Remove the pairwise rows, and reuse one of them for the clique
+        vector<uint32_t> covered;
+        for (size_t a = 0; a < clique.size(); ++a) {
+            for (size_t b = a + 1; b < clique.size(); ++b) {
+                uint32_t r = edges[edgeKey(clique[a], clique[b])];
+                if (!rows[r].removed)
+                    covered.push_back(r);
+            }
+        }
+        // Not worth a new row if the pairwise rows were already merged
+        if (covered.size() < 2)
+            continue;
+        for (uint32_t r : covered) {
+            rows[r].removed = true;
+        }
+        // sum(x for positive literals) + sum(1 - x for complemented ones) <= 1
+        LinearRow &row = rows[covered[0]];
+        row.removed = false;
+        row.modified = true;
+        row.vars.clear();
+        row.coefs.clear();
+        row.lb = -INFINITY;
+        row.ub = 1.0;
+        for (Literal l : clique) {
+            row.vars.push_back(l / 2);
+            row.coefs.push_back(l % 2 ? -1.0 : 1.0);
+            if (l % 2)
+                row.ub -= 1.0;
+        }
+        changed = true;
+    }
+    if (!changed)
+        return;
+    Rewriter rewriter(model);
+    linearRows.rewriteDecisions(rewriter);
+    linearRows.rewriteRows(rewriter);
+    rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
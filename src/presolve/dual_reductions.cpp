@@ -0,0 +1,291 @@
+#include "presolve/dual_reductions.hpp"
+
+#include "presolve/linear_rows.hpp"
+#include "model/operator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class DualReductions::Reducer {
+  public:
+    Reducer(PresolvedModel &model);
+    bool run();
+    void rewrite();
+
+  private:
+    void readObjectives();
+    void computeLocks();
+
+    // Fix the variables that can move towards a better objective without
+    // violating any row
+    void dualFixing();
+    // Fix the columns dominated by a column with the same rows
+    void dominatedColumns();
+    // Whether increasing j and decreasing k by the same amount never
+    // worsens the objective nor violates a row
+    bool dominates(uint32_t j, uint32_t k) const;
+    // Remove the rows that a free column singleton can always satisfy
+    void freeColumnSingletons();
+
+    bool fixable(uint32_t var) const {
+        return !protected_[var] && !fixed[var] && !linearRows.eliminated()[var];
+    }
+    void fix(uint32_t var, double val);
+
+  private:
+    PresolvedModel &model;
+    LinearRows linearRows;
+    vector<LinearRow> &rows;
+    vector<Interval> &varBounds;
+
+    // Rows using each variable
+    vector<vector<uint32_t>> columns;
+    // Objective coefficients, for a minimization
+    vector<double> cost;
+    // Variables whose value must not be chosen by this pass
+    vector<char> protected_;
+    vector<char> fixed;
+    // Number of rows preventing a decrease or an increase of each variable
+    vector<uint32_t> downLocks;
+    vector<uint32_t> upLocks;
+    // Removed column singletons and their row
+    vector<pair<uint32_t, uint32_t>> singletons;
+    bool reduced;
+};
+
+DualReductions::Reducer::Reducer(PresolvedModel &model)
+    : model(model), linearRows(model), rows(linearRows.rows()),
+      varBounds(linearRows.bounds()), columns(model.nbExpressions()),
+      cost(model.nbExpressions()), protected_(model.nbExpressions()),
+      fixed(model.nbExpressions()), downLocks(model.nbExpressions()),
+      upLocks(model.nbExpressions()), reduced(false) {
+    for (uint32_t r = 0; r < rows.size(); ++r) {
+        if (rows[r].modified)
+            reduced = true;
+        for (uint32_t var : rows[r].vars) {
+            columns[var].push_back(r);
+        }
+    }
+    // The values of the previous postsolve targets are chosen by their record
+    for (const PresolvedModel::PostsolveRecord &record :
+         model.postsolveStack()) {
+        protected_[record.target.var()] = true;
+    }
+    readObjectives();
+    computeLocks();
+}
+
+void DualReductions::Reducer::readObjectives() {
+    // With several objectives, no direction is always better
+    bool single = model.nbObjectives() == 1;
+    for (const Model::ObjectiveData &obj : model.objectives()) {
+        double sign = obj.second == UMO_OBJ_MAXIMIZE ? -1.0 : 1.0;
+        if (obj.first.isMinus() || obj.first.isNot())
+            sign = -sign;
+        uint32_t var = obj.first.var();
+        const Model::ExpressionData &expr = model.expression(var);
+        if (Operator::get(expr.op).isDecision()) {
+            cost[var] += sign;
+            if (!single)
+                protected_[var] = true;
+            continue;
+        }
+        for (size_t j = 0; 2 * j + 1 < expr.operands.size(); ++j) {
+            ExpressionId op = expr.operands[2 * j + 1];
+            double coef = model.getExpressionIdValue(expr.operands[2 * j]);
+            if (expr.op != UMO_OP_LINEAR || op.isNot() || op.isMinus() || !single)
+                protected_[op.var()] = true;
+            else
+                cost[op.var()] += sign * coef;
+        }
+    }
+}
+
+void DualReductions::Reducer::computeLocks() {
+    for (const LinearRow &row : rows) {
+        if (row.removed)
+            continue;
+        for (size_t j = 0; j < row.vars.size(); ++j) {
+            uint32_t var = row.vars[j];
+            if (row.coefs[j] == 0.0)
+                continue;
+            bool positive = row.coefs[j] > 0.0;
+            if (isfinite(row.ub))
+                ++(positive ? upLocks : downLocks)[var];
+            if (isfinite(row.lb))
+                ++(positive ? downLocks : upLocks)[var];
+        }
+    }
+}
+
+bool DualReductions::Reducer::run() {
+    dualFixing();
+    dominatedColumns();
+    freeColumnSingletons();
+    return reduced;
+}
+
+void DualReductions::Reducer::fix(uint32_t var, double val) {
+    varBounds[var] = Interval(val);
+    fixed[var] = true;
+    reduced = true;
+}
+
+void DualReductions::Reducer::dualFixing() {
+    for (uint32_t var = 0; var < model.nbExpressions(); ++var) {
+        if (!Operator::get(model.expression(var).op).isDecision() ||
+            !fixable(var))
+            continue;
+        const Interval &bounds = varBounds[var];
+        if (bounds.isPoint())
+            continue;
+        double c = cost[var];
+        if (c >= 0.0 && downLocks[var] == 0 && isfinite(bounds.lb)) {
+            fix(var, bounds.lb);
+        } else if (c <= 0.0 && upLocks[var] == 0 && isfinite(bounds.ub)) {
+            fix(var, bounds.ub);
+        } else if (c == 0.0 && downLocks[var] == 0 && upLocks[var] == 0) {
+            // Unused free variable
+            fix(var, min(max(0.0, bounds.lb), bounds.ub));
+        }
+    }
+}
+
+bool DualReductions::Reducer::dominates(uint32_t j, uint32_t k) const {
+    if (cost[j] > cost[k])
+        return false;
+    // The amount moved from k to j must keep j integer
+    if (linearRows.isInteger(j) && !linearRows.isInteger(k))
+        return false;
+    // Both columns have the same rows, in the same order
+    for (uint32_t r : columns[j]) {
+        const LinearRow &row = rows[r];
+        double aj = 0.0;
+        double ak = 0.0;
+        for (size_t p = 0; p < row.vars.size(); ++p) {
+            if (row.vars[p] == j)
+                aj = row.coefs[p];
+            if (row.vars[p] == k)
+                ak = row.coefs[p];
+        }
+        if (isfinite(row.ub) && aj > ak)
+            return false;
+        if (isfinite(row.lb) && aj < ak)
+            return false;
+    }
+    return true;
+}
+
+void DualReductions::Reducer::dominatedColumns() {
+    // Group the columns by their rows
+    unordered_map<size_t, vector<uint32_t>> buckets;
+    for (uint32_t var = 0; var < model.nbExpressions(); ++var) {
+        if (columns[var].empty() || protected_[var] ||
+            linearRows.eliminated()[var] || varBounds[var].isPoint())
+            continue;
+        size_t h = columns[var].size();
+        for (uint32_t r : columns[var]) {
+            h ^= hash<uint32_t>()(r) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        buckets[h].push_back(var);
+    }
+    for (auto &bucket : buckets) {
+        const vector<uint32_t> &vars = bucket.second;
+        for (uint32_t k : vars) {
+            if (!isfinite(varBounds[k].lb))
+                continue;
+            for (uint32_t j : vars) {
+                // The dominating column must remain free to increase
+                if (j == k || fixed[j] || isfinite(varBounds[j].ub))
+                    continue;
+                if (columns[j] != columns[k] || !dominates(j, k))
+                    continue;
+                fix(k, varBounds[k].lb);
+                break;
+            }
+        }
+    }
+}
+
+void DualReductions::Reducer::freeColumnSingletons() {
+    vector<char> rowUsed(rows.size());
+    for (uint32_t var = 0; var < model.nbExpressions(); ++var) {
+        if (columns[var].size() != 1 || cost[var] != 0.0 || !fixable(var))
+            continue;
+        uint32_t r = columns[var][0];
+        LinearRow &row = rows[r];
+        if (row.removed || rowUsed[r])
+            continue;
+        // Integer variables cannot satisfy an equality in general
+        if (linearRows.isInteger(var) && isfinite(row.lb) && isfinite(row.ub))
+            continue;
+        double a = 0.0;
+        Interval rest(0.0);
+        for (size_t p = 0; p < row.vars.size(); ++p) {
+            if (row.vars[p] == var)
+                a = row.coefs[p];
+            else
+                rest = rest + Interval(row.coefs[p]) * varBounds[row.vars[p]];
+        }
+        if (a == 0.0)
+            continue;
+        // The row must be satisfiable for any value of the other variables
+        Interval column = Interval(a) * varBounds[var];
+        if (isfinite(row.ub) && !(column.lb <= row.ub - rest.ub))
+            continue;
+        if (isfinite(row.lb) && !(row.lb - rest.lb <= column.ub))
+            continue;
+        rowUsed[r] = true;
+        row.removed = true;
+        protected_[var] = true;
+        singletons.emplace_back(var, r);
+        reduced = true;
+    }
+}
+
+void DualReductions::Reducer::rewrite() {
+    Rewriter rewriter(model);
+    PresolvedModel &newModel = rewriter.newModel();
+    linearRows.rewriteDecisions(rewriter);
+    linearRows.rewriteRows(rewriter);
+    for (const auto &singleton : singletons) {
+        const LinearRow &row = rows[singleton.second];
+        PresolvedModel::PostsolveRecord record;
+        record.target = rewriter.get(ExpressionId::fromVar(singleton.first));
+        record.coef = 0.0;
+        record.lb = row.lb;
+        record.ub = row.ub;
+        for (size_t p = 0; p < row.vars.size(); ++p) {
+            ExpressionId id = rewriter.get(ExpressionId::fromVar(row.vars[p]));
+            if (row.vars[p] == singleton.first) {
+                record.coef += row.coefs[p];
+            } else if (newModel.isConstant(id.var())) {
+                double val = row.coefs[p] * newModel.getExpressionIdValue(id);
+                record.lb -= val;
+                record.ub -= val;
+            } else {
+                record.operands.push_back(id);
+                record.coefs.push_back(row.coefs[p]);
+            }
+        }
+        newModel.addPostsolve(record);
+    }
+    rewriter.run();
+}
+
+void DualReductions::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    Reducer reducer(model);
+    if (reducer.run())
+        reducer.rewrite();
+}
+
+} // namespace presolve
+} // namespace umoi
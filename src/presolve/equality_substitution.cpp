@@ -0,0 +1,342 @@
+#include "presolve/equality_substitution.hpp"
+
+#include "presolve/linear_rows.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class EqualitySubstitution::Substitution {
+  public:
+    Substitution(PresolvedModel &model);
+    bool run();
+    void rewrite();
+
+  private:
+    // Definition of an eliminated variable: constant + sum(coefs * vars)
+    struct Definition {
+        uint32_t var;
+        double constant;
+        vector<uint32_t> vars;
+        vector<double> coefs;
+    };
+
+    void readObjectives();
+
+    // Number of rows using a variable, stopping at 3
+    int countRows(uint32_t var) const;
+    // Whether the variable at this position may be defined by the row
+    // without losing its integrality
+    bool canEliminate(const LinearRow &row, size_t pos) const;
+    // Choose the variable to eliminate with an equality row, or -1
+    int chooseVariable(const LinearRow &row) const;
+    // Bounds of the variable at this position that are not implied by the
+    // row; the others are made infinite
+    Interval residualBounds(const LinearRow &row, size_t pos) const;
+
+    void eliminate(uint32_t r, size_t pos);
+    void substitute(uint32_t s, const Definition &def);
+    // Check the feasibility of a row without variables and remove it
+    void removeEmpty(LinearRow &row);
+
+  private:
+    PresolvedModel &model;
+    LinearRows linearRows;
+    vector<LinearRow> &rows;
+    vector<Interval> &varBounds;
+
+    // Rows using each variable; may contain rows that do not use it anymore
+    vector<vector<uint32_t>> columns;
+    vector<char> inObjective;
+    // Definitions in the order of elimination
+    vector<Definition> definitions;
+    deque<uint32_t> pending;
+    bool infeasible;
+
+    const double zeroTolerance = 1.0e-12;
+    const double feasibilityTolerance = LinearRows::feasibilityTolerance;
+};
+
+EqualitySubstitution::Substitution::Substitution(PresolvedModel &model)
+    : model(model), linearRows(model), rows(linearRows.rows()),
+      varBounds(linearRows.bounds()), columns(model.nbExpressions()),
+      inObjective(model.nbExpressions()), infeasible(false) {
+    for (uint32_t r = 0; r < rows.size(); ++r) {
+        for (uint32_t var : rows[r].vars) {
+            columns[var].push_back(r);
+        }
+        if (rows[r].isEquality())
+            pending.push_back(r);
+    }
+    readObjectives();
+}
+
+void EqualitySubstitution::Substitution::readObjectives() {
+    for (const Model::ObjectiveData &obj : model.objectives()) {
+        uint32_t var = obj.first.var();
+        inObjective[var] = true;
+        const Model::ExpressionData &expr = model.expression(var);
+        if (expr.op == UMO_OP_LINEAR) {
+            for (size_t j = 0; 2 * j + 1 < expr.operands.size(); ++j) {
+                inObjective[expr.operands[2 * j + 1].var()] = true;
+            }
+        }
+    }
+}
+
+int EqualitySubstitution::Substitution::countRows(uint32_t var) const {
+    vector<uint32_t> seen;
+    for (uint32_t r : columns[var]) {
+        const LinearRow &row = rows[r];
+        if (row.removed)
+            continue;
+        if (find(seen.begin(), seen.end(), r) != seen.end())
+            continue;
+        if (find(row.vars.begin(), row.vars.end(), var) == row.vars.end())
+            continue;
+        seen.push_back(r);
+        if (seen.size() >= 3)
+            break;
+    }
+    return seen.size();
+}
+
+namespace {
+bool isIntegral(double val) { return abs(val - round(val)) <= 1.0e-9; }
+} // namespace
+
+bool EqualitySubstitution::Substitution::canEliminate(const LinearRow &row,
+                                                      size_t pos) const {
+    uint32_t var = row.vars[pos];
+    if (!linearRows.isInteger(var))
+        return true;
+    double coef = row.coefs[pos];
+    if (!isIntegral(row.lb / coef))
+        return false;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        if (j == pos)
+            continue;
+        if (!linearRows.isInteger(row.vars[j]) || !isIntegral(row.coefs[j] / coef))
+            return false;
+    }
+    return true;
+}
+
+int EqualitySubstitution::Substitution::chooseVariable(const LinearRow &row) const {
+    int best = -1;
+    int bestScore = 0;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        uint32_t var = row.vars[j];
+        if (inObjective[var])
+            continue;
+        // Beyond doubletons, only substitute variables with a single use to
+        // avoid fill-in
+        if (row.vars.size() > 2 && countRows(var) > 2)
+            continue;
+        if (!canEliminate(row, j))
+            continue;
+        Interval residual = residualBounds(row, j);
+        int nbImplied = (residual.lb == -numeric_limits<double>::infinity()) +
+                        (residual.ub == numeric_limits<double>::infinity());
+        // Do not turn an equality into a ranged row
+        if (row.vars.size() > 2 && nbImplied == 0)
+            continue;
+        // Prefer variables with implied bounds, then continuous variables
+        int score = 2 * nbImplied + !linearRows.isInteger(var);
+        if (best == -1 || score > bestScore) {
+            best = j;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+Interval EqualitySubstitution::Substitution::residualBounds(const LinearRow &row,
+                                                            size_t pos) const {
+    Interval bounds = varBounds[row.vars[pos]];
+    double coef = row.coefs[pos];
+    Interval implied(row.lb / coef);
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        if (j == pos)
+            continue;
+        implied = implied - Interval(row.coefs[j] / coef) * varBounds[row.vars[j]];
+    }
+    double tol = feasibilityTolerance;
+    if (implied.lb >= bounds.lb - tol * max(1.0, abs(bounds.lb)))
+        bounds.lb = -numeric_limits<double>::infinity();
+    if (implied.ub <= bounds.ub + tol * max(1.0, abs(bounds.ub)))
+        bounds.ub = numeric_limits<double>::infinity();
+    return bounds;
+}
+
+bool EqualitySubstitution::Substitution::run() {
+    while (!pending.empty() && !infeasible) {
+        uint32_t r = pending.front();
+        pending.pop_front();
+        const LinearRow &row = rows[r];
+        if (row.removed || !row.isEquality())
+            continue;
+        int pos = chooseVariable(row);
+        if (pos == -1)
+            continue;
+        eliminate(r, pos);
+    }
+    return !infeasible;
+}
+
+void EqualitySubstitution::Substitution::eliminate(uint32_t r, size_t pos) {
+    LinearRow &row = rows[r];
+    uint32_t var = row.vars[pos];
+    double coef = row.coefs[pos];
+    Definition def;
+    def.var = var;
+    def.constant = row.lb / coef;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        if (j == pos)
+            continue;
+        def.vars.push_back(row.vars[j]);
+        def.coefs.push_back(-row.coefs[j] / coef);
+    }
+    if (linearRows.isInteger(var)) {
+        // Integral by construction: remove rounding errors so that the
+        // recovered value is an exact integer
+        def.constant = round(def.constant);
+        for (double &c : def.coefs) {
+            c = round(c);
+        }
+    }
+
+    // The bounds of the variable now apply to its definition; keep the row
+    // to enforce them unless they are implied
+    Interval residual = residualBounds(row, pos);
+    if (residual == Interval()) {
+        row.removed = true;
+    } else {
+        Interval rowBounds = Interval(row.lb) - Interval(coef) * residual;
+        row.vars.erase(row.vars.begin() + pos);
+        row.coefs.erase(row.coefs.begin() + pos);
+        row.lb = rowBounds.lb;
+        row.ub = rowBounds.ub;
+        row.modified = true;
+        if (row.vars.empty())
+            removeEmpty(row);
+    }
+
+    vector<uint32_t> users = columns[var];
+    columns[var].clear();
+    for (uint32_t s : users) {
+        if (s == r || rows[s].removed)
+            continue;
+        substitute(s, def);
+    }
+    linearRows.eliminated()[var] = true;
+    definitions.push_back(def);
+}
+
+void EqualitySubstitution::Substitution::substitute(uint32_t s,
+                                                    const Definition &def) {
+    LinearRow &row = rows[s];
+    auto it = find(row.vars.begin(), row.vars.end(), def.var);
+    if (it == row.vars.end())
+        return;
+    size_t pos = it - row.vars.begin();
+    double factor = row.coefs[pos];
+    row.vars.erase(row.vars.begin() + pos);
+    row.coefs.erase(row.coefs.begin() + pos);
+
+    unordered_map<uint32_t, size_t> index;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        index.emplace(row.vars[j], j);
+    }
+    for (size_t j = 0; j < def.vars.size(); ++j) {
+        uint32_t var = def.vars[j];
+        double coef = factor * def.coefs[j];
+        auto it = index.find(var);
+        if (it != index.end()) {
+            row.coefs[it->second] += coef;
+        } else {
+            index.emplace(var, row.vars.size());
+            row.vars.push_back(var);
+            row.coefs.push_back(coef);
+            columns[var].push_back(s);
+        }
+    }
+    // Remove the coefficients that cancelled out
+    size_t nb = 0;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        if (abs(row.coefs[j]) <= zeroTolerance)
+            continue;
+        row.vars[nb] = row.vars[j];
+        row.coefs[nb] = row.coefs[j];
+        ++nb;
+    }
+    row.vars.resize(nb);
+    row.coefs.resize(nb);
+
+    double offset = factor * def.constant;
+    row.lb -= offset;
+    row.ub -= offset;
+    row.modified = true;
+    if (row.vars.empty())
+        removeEmpty(row);
+    else if (row.isEquality())
+        pending.push_back(s);
+}
+
+void EqualitySubstitution::Substitution::removeEmpty(LinearRow &row) {
+    double tol = feasibilityTolerance;
+    if (row.lb > tol * max(1.0, abs(row.lb)) ||
+        row.ub < -tol * max(1.0, abs(row.ub)))
+        infeasible = true;
+    row.removed = true;
+}
+
+void EqualitySubstitution::Substitution::rewrite() {
+    if (definitions.empty())
+        return;
+    Rewriter rewriter(model);
+    PresolvedModel &newModel = rewriter.newModel();
+    linearRows.rewriteDecisions(rewriter);
+    // Definitions only use variables that are kept or eliminated later
+    for (auto it = definitions.rbegin(); it != definitions.rend(); ++it) {
+        const Definition &def = *it;
+        if (def.vars.empty()) {
+            rewriter.replace(def.var, newModel.createConstant(def.constant));
+            continue;
+        }
+        vector<ExpressionId> operands;
+        for (size_t j = 0; j < def.vars.size(); ++j) {
+            operands.push_back(newModel.createConstant(def.coefs[j]));
+            operands.push_back(rewriter.get(ExpressionId::fromVar(def.vars[j])));
+        }
+        if (def.constant != 0.0) {
+            operands.push_back(newModel.createConstant(def.constant));
+            operands.push_back(newModel.createConstant(1.0));
+        }
+        rewriter.replace(def.var,
+                         newModel.createExpression(UMO_OP_LINEAR, operands));
+    }
+    linearRows.rewriteRows(rewriter);
+    rewriter.run();
+}
+
+void EqualitySubstitution::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    Substitution substitution(model);
+    if (!substitution.run()) {
+        model.setInfeasible();
+        return;
+    }
+    substitution.rewrite();
+}
+
+} // namespace presolve
+} // namespace umoi
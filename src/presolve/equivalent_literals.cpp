@@ -0,0 +1,498 @@
+#include "presolve/equivalent_literals.hpp"
+
+#include "model/operator.hpp"
+#include "presolve/rewriter.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class EquivalentLiterals::Detector {
+  public:
+    Detector(const PresolvedModel &model);
+    // Return false if a literal is equivalent to its complement
+    bool run();
+    bool merged() const { return merged_; }
+    void rewrite(Rewriter &rewriter);
+
+  private:
+    static bool isGate(umo_operator op) {
+        return op == UMO_OP_AND || op == UMO_OP_OR || op == UMO_OP_XOR;
+    }
+    bool isBool(uint32_t i) const {
+        const Model::ExpressionData &expr = model_.expression(i);
+        return expr.type == UMO_TYPE_BOOL && expr.op != UMO_OP_CONSTANT &&
+               expr.op != UMO_OP_INVALID;
+    }
+    // Literals of the implication graph: 2 * var + not bit
+    static uint32_t toLit(ExpressionId id) {
+        return 2 * id.var() + (id.isNot() ? 1 : 0);
+    }
+    static ExpressionId fromLit(uint32_t lit) {
+        return ExpressionId(lit / 2, lit % 2 != 0, false);
+    }
+
+    // a => b, and !b => !a
+    void addImplication(ExpressionId a, ExpressionId b);
+    void addClause(ExpressionId a, ExpressionId b) {
+        addImplication(a.getNot(), b);
+    }
+    void readImplications();
+    void mergeComponents();
+    void hashGates();
+    void simulate();
+    // Exhaustive check of a == b on the inputs of their AND/OR/XOR cones
+    bool checkEquivalent(ExpressionId a, ExpressionId b) const;
+
+    // Representative of an expression, with the NOT bit if complementary
+    ExpressionId find(ExpressionId id);
+    void merge(ExpressionId a, ExpressionId b);
+
+  private:
+    const PresolvedModel &model_;
+    vector<vector<uint32_t>> implications_;
+    // Union-find over the expressions, with the parity to the parent
+    vector<uint32_t> parent_;
+    vector<char> flip_;
+    bool merged_;
+    bool conflict_;
+
+    // Limits of the exhaustive checks
+    const size_t maxInputs = 10;
+    const size_t maxConeSize = 256;
+    const int maxChecks = 200;
+    const int nbSimulationWords = 4;
+};
+
+EquivalentLiterals::Detector::Detector(const PresolvedModel &model)
+    : model_(model), implications_(2 * model.nbExpressions()),
+      parent_(model.nbExpressions()), flip_(model.nbExpressions()),
+      merged_(false), conflict_(false) {
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        parent_[i] = i;
+    }
+}
+
+bool EquivalentLiterals::Detector::run() {
+    readImplications();
+    mergeComponents();
+    hashGates();
+    simulate();
+    return !conflict_;
+}
+
+ExpressionId EquivalentLiterals::Detector::find(ExpressionId id) {
+    uint32_t root = id.var();
+    bool parity = false;
+    while (parent_[root] != root) {
+        parity ^= flip_[root] != 0;
+        root = parent_[root];
+    }
+    // Path compression
+    uint32_t cur = id.var();
+    bool curParity = parity;
+    while (parent_[cur] != cur) {
+        uint32_t next = parent_[cur];
+        bool nextParity = curParity ^ (flip_[cur] != 0);
+        parent_[cur] = root;
+        flip_[cur] = curParity;
+        cur = next;
+        curParity = nextParity;
+    }
+    return ExpressionId(root, parity ^ id.isNot(), false);
+}
+
+void EquivalentLiterals::Detector::merge(ExpressionId a, ExpressionId b) {
+    // Constants are left to the propagation
+    if (!isBool(a.var()) || !isBool(b.var()))
+        return;
+    ExpressionId ra = find(a);
+    ExpressionId rb = find(b);
+    if (ra.var() == rb.var()) {
+        if (ra.isNot() != rb.isNot())
+            conflict_ = true;
+        return;
+    }
+    // The first expression is the representative, so that replacements
+    // respect the topological order
+    if (ra.var() > rb.var())
+        swap(ra, rb);
+    parent_[rb.var()] = ra.var();
+    flip_[rb.var()] = ra.isNot() != rb.isNot();
+    merged_ = true;
+}
+
+void EquivalentLiterals::Detector::addImplication(ExpressionId a,
+                                                  ExpressionId b) {
+    implications_[toLit(a)].push_back(toLit(b));
+    implications_[toLit(b.getNot())].push_back(toLit(a.getNot()));
+}
+
+void EquivalentLiterals::Detector::readImplications() {
+    for (ExpressionId c : model_.constraints()) {
+        const Model::ExpressionData &expr = model_.expression(c.var());
+        if (expr.operands.size() != 2 || !isBool(c.var()))
+            continue;
+        ExpressionId a = expr.operands[0];
+        ExpressionId b = expr.operands[1];
+        bool binary = isBool(a.var()) && isBool(b.var());
+        if (!binary)
+            continue;
+        switch (expr.op) {
+        case UMO_OP_OR:
+            if (!c.isNot())
+                addClause(a, b);
+            break;
+        case UMO_OP_AND:
+            if (c.isNot())
+                addClause(a.getNot(), b.getNot());
+            break;
+        case UMO_OP_XOR:
+        case UMO_OP_CMP_NEQ:
+            merge(a, c.isNot() ? b : b.getNot());
+            break;
+        case UMO_OP_CMP_EQ:
+            merge(a, c.isNot() ? b.getNot() : b);
+            break;
+        default:
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        ExpressionId node = ExpressionId::fromVar(i);
+        for (ExpressionId op : expr.operands) {
+            if (expr.op == UMO_OP_AND)
+                addImplication(node, op);
+            else if (expr.op == UMO_OP_OR)
+                addImplication(op, node);
+        }
+    }
+}
+
+void EquivalentLiterals::Detector::mergeComponents() {
+    // Iterative Tarjan algorithm on the literals
+    size_t n = implications_.size();
+    vector<int> index(n, -1);
+    vector<int> lowLink(n, 0);
+    vector<char> onStack(n);
+    vector<uint32_t> stack;
+    vector<pair<uint32_t, size_t>> callStack;
+    int counter = 0;
+    for (uint32_t start = 0; start < n; ++start) {
+        if (index[start] >= 0 || implications_[start].empty())
+            continue;
+        callStack.emplace_back(start, 0);
+        while (!callStack.empty()) {
+            uint32_t v = callStack.back().first;
+            size_t &next = callStack.back().second;
+            if (next == 0 && index[v] < 0) {
+                index[v] = lowLink[v] = counter++;
+                stack.push_back(v);
+                onStack[v] = true;
+            }
+            if (next < implications_[v].size()) {
+                uint32_t w = implications_[v][next++];
+                if (index[w] < 0) {
+                    callStack.emplace_back(w, 0);
+                } else if (onStack[w]) {
+                    lowLink[v] = min(lowLink[v], index[w]);
+                }
+                continue;
+            }
+            if (lowLink[v] == index[v]) {
+                // Root of a component: all its literals are equivalent
+                while (true) {
+                    uint32_t w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    if (w != v)
+                        merge(fromLit(v), fromLit(w));
+                    if (w == v)
+                        break;
+                }
+            }
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                uint32_t u = callStack.back().first;
+                lowLink[u] = min(lowLink[u], lowLink[v]);
+            }
+        }
+    }
+}
+
+void EquivalentLiterals::Detector::hashGates() {
+    // Gates are normalized as AND or XOR over representatives, possibly
+    // negated
+    map<pair<int, vector<uint32_t>>, ExpressionId> gates;
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (!isGate(expr.op))
+            continue;
+        bool isXor = expr.op == UMO_OP_XOR;
+        bool negated = expr.op == UMO_OP_OR;
+        vector<uint32_t> lits;
+        for (ExpressionId op : expr.operands) {
+            ExpressionId rep = find(negated ? op.getNot() : op);
+            if (isXor) {
+                negated ^= rep.isNot();
+                rep = ExpressionId::fromVar(rep.var());
+            }
+            lits.push_back(toLit(rep));
+        }
+        sort(lits.begin(), lits.end());
+        if (isXor) {
+            // Pairs of identical operands cancel out
+            vector<uint32_t> odd;
+            for (uint32_t lit : lits) {
+                if (!odd.empty() && odd.back() == lit)
+                    odd.pop_back();
+                else
+                    odd.push_back(lit);
+            }
+            lits = odd;
+        } else {
+            lits.erase(unique(lits.begin(), lits.end()), lits.end());
+            bool complementary = false;
+            for (size_t j = 1; j < lits.size(); ++j) {
+                complementary |= lits[j] == (lits[j - 1] ^ 1);
+            }
+            if (complementary)
+                continue;
+        }
+        // Literal of the node equal to the normalized gate
+        ExpressionId node(i, negated, false);
+        if (lits.size() == 1) {
+            merge(node, fromLit(lits[0]));
+            continue;
+        }
+        if (lits.empty())
+            continue;
+        auto it = gates.emplace(make_pair((int)isXor, lits), node);
+        if (!it.second)
+            merge(node, it.first->second);
+    }
+}
+
+void EquivalentLiterals::Detector::simulate() {
+    size_t nbWords = nbSimulationWords;
+    uint32_t n = model_.nbExpressions();
+    vector<uint64_t> signatures(n * nbWords);
+    mt19937_64 rgen(1);
+    auto word = [&](ExpressionId id, size_t w) {
+        uint64_t val = signatures[id.var() * nbWords + w];
+        return id.isNot() ? ~val : val;
+    };
+    for (uint32_t i = 0; i < n; ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (expr.type != UMO_TYPE_BOOL)
+            continue;
+        for (size_t w = 0; w < nbWords; ++w) {
+            uint64_t val;
+            if (expr.op == UMO_OP_CONSTANT) {
+                val = model_.value(i) == 1.0 ? ~(uint64_t)0 : 0;
+            } else if (expr.op == UMO_OP_AND) {
+                val = ~(uint64_t)0;
+                for (ExpressionId op : expr.operands)
+                    val &= word(op, w);
+            } else if (expr.op == UMO_OP_OR) {
+                val = 0;
+                for (ExpressionId op : expr.operands)
+                    val |= word(op, w);
+            } else if (expr.op == UMO_OP_XOR) {
+                val = 0;
+                for (ExpressionId op : expr.operands)
+                    val ^= word(op, w);
+            } else {
+                // Inputs of the boolean structure
+                val = rgen();
+            }
+            signatures[i * nbWords + w] = val;
+        }
+    }
+    // Candidates have the same signature, up to complement
+    unordered_map<uint64_t, vector<ExpressionId>> candidates;
+    int nbChecks = 0;
+    for (uint32_t i = 0; i < n && nbChecks < maxChecks; ++i) {
+        if (!isBool(i))
+            continue;
+        ExpressionId node = ExpressionId::fromVar(i);
+        if (word(node, 0) & 1)
+            node = node.getNot();
+        uint64_t h = 0;
+        bool constant = true;
+        for (size_t w = 0; w < nbWords; ++w) {
+            h = h * 0x9e3779b97f4a7c15ULL + word(node, w);
+            constant &= word(node, w) == 0;
+        }
+        if (constant)
+            continue;
+        vector<ExpressionId> &bucket = candidates[h];
+        bool found = false;
+        for (ExpressionId other : bucket) {
+            bool same = true;
+            for (size_t w = 0; w < nbWords; ++w) {
+                same &= word(other, w) == word(node, w);
+            }
+            if (!same)
+                continue;
+            if (find(other) == find(node)) {
+                found = true;
+                break;
+            }
+            ++nbChecks;
+            if (checkEquivalent(other, node)) {
+                merge(other, node);
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            bucket.push_back(node);
+    }
+}
+
+bool EquivalentLiterals::Detector::checkEquivalent(ExpressionId a,
+                                                   ExpressionId b) const {
+    // Cone of AND/OR/XOR nodes, in topological order
+    vector<uint32_t> cone;
+    vector<uint32_t> inputs;
+    vector<uint32_t> todo = {a.var(), b.var()};
+    unordered_map<uint32_t, size_t> position;
+    while (!todo.empty()) {
+        uint32_t i = todo.back();
+        todo.pop_back();
+        if (position.count(i))
+            continue;
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (isGate(expr.op)) {
+            position[i] = cone.size();
+            cone.push_back(i);
+            for (ExpressionId op : expr.operands) {
+                todo.push_back(op.var());
+            }
+        } else {
+            position[i] = inputs.size();
+            inputs.push_back(i);
+        }
+        if (cone.size() > maxConeSize || inputs.size() > maxInputs)
+            return false;
+    }
+    sort(cone.begin(), cone.end());
+    for (size_t j = 0; j < cone.size(); ++j) {
+        position[cone[j]] = j;
+    }
+    vector<char> isInput(model_.nbExpressions());
+    for (uint32_t i : inputs) {
+        isInput[i] = true;
+    }
+    vector<char> coneValues(cone.size());
+    vector<char> inputValues(inputs.size());
+    auto value = [&](ExpressionId id) {
+        uint32_t i = id.var();
+        bool val;
+        if (!isInput[i])
+            val = coneValues[position[i]];
+        else if (model_.isConstant(i))
+            val = model_.value(i) == 1.0;
+        else
+            val = inputValues[position[i]];
+        return val ^ id.isNot();
+    };
+    for (uint64_t assignment = 0; assignment < (1ULL << inputs.size());
+         ++assignment) {
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            inputValues[j] = (assignment >> j) & 1;
+        }
+        for (size_t j = 0; j < cone.size(); ++j) {
+            const Model::ExpressionData &expr = model_.expression(cone[j]);
+            bool val = expr.op == UMO_OP_AND;
+            for (ExpressionId op : expr.operands) {
+                if (expr.op == UMO_OP_AND)
+                    val &= value(op);
+                else if (expr.op == UMO_OP_OR)
+                    val |= value(op);
+                else
+                    val ^= value(op);
+            }
+            coneValues[j] = val;
+        }
+        if (value(a) != value(b))
+            return false;
+    }
+    return true;
+}
+
+void EquivalentLiterals::Detector::rewrite(Rewriter &rewriter) {
+    PresolvedModel &newModel = rewriter.newModel();
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (expr.op == UMO_OP_CONSTANT || expr.op == UMO_OP_INVALID)
+            continue;
+        ExpressionId rep = find(ExpressionId::fromVar(i));
+        if (rep.var() != i) {
+            rewriter.replace(i, rewriter.get(rep));
+            continue;
+        }
+        if (!isGate(expr.op)) {
+            rewriter.copy(i);
+            continue;
+        }
+        // Operands may have become identical or complementary
+        vector<ExpressionId> operands;
+        bool parity = false;
+        bool complementary = false;
+        for (ExpressionId op : expr.operands) {
+            ExpressionId id = rewriter.get(op);
+            if (expr.op == UMO_OP_XOR) {
+                parity ^= id.isNot();
+                id = ExpressionId::fromVar(id.var());
+            }
+            operands.push_back(id);
+        }
+        sort(operands.begin(), operands.end());
+        vector<ExpressionId> simplified;
+        for (ExpressionId id : operands) {
+            if (simplified.empty() || simplified.back().var() != id.var()) {
+                simplified.push_back(id);
+            } else if (expr.op == UMO_OP_XOR) {
+                simplified.pop_back();
+            } else if (simplified.back() != id) {
+                complementary = true;
+            }
+        }
+        if (complementary) {
+            double val = expr.op == UMO_OP_OR ? 1.0 : 0.0;
+            rewriter.replace(i, newModel.createConstant(val));
+        } else if (simplified.empty()) {
+            rewriter.replace(i, newModel.createConstant(parity ? 1.0 : 0.0));
+        } else if (simplified.size() == 1) {
+            rewriter.replace(i, parity ? simplified[0].getNot() : simplified[0]);
+        } else {
+            ExpressionId newId = newModel.createExpression(expr.op, simplified);
+            rewriter.replace(i, parity ? newId.getNot() : newId);
+        }
+    }
+}
+
+void EquivalentLiterals::run(PresolvedModel &model) const {
+    Detector detector(model);
+    if (!detector.run()) {
+        model.setInfeasible();
+        return;
+    }
+    if (!detector.merged())
+        return;
+    Rewriter rewriter(model);
+    detector.rewrite(rewriter);
+    rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
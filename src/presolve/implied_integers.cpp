@@ -0,0 +1,96 @@
+#include "presolve/implied_integers.hpp"
+
+#include "model/operator.hpp"
+#include "presolve/linear_rows.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+namespace {
+bool isIntegral(double val) {
+    double tol = LinearRows::feasibilityTolerance;
+    return abs(val - round(val)) <= tol * max(1.0, abs(val));
+}
+} // namespace
+
+void ImpliedIntegers::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    LinearRows linearRows(model);
+    const vector<LinearRow> &rows = linearRows.rows();
+    const vector<Interval> &bounds = linearRows.bounds();
+
+    // Values of the original decisions must be integer when pushed,
+    // including those computed from the variables of a definition left by
+    // an earlier pass
+    vector<char> mapped(model.nbExpressions());
+    vector<uint32_t> pending;
+    for (ExpressionId id : model.mapping()) {
+        if (id.valid() && !mapped[id.var()]) {
+            mapped[id.var()] = true;
+            pending.push_back(id.var());
+        }
+    }
+    while (!pending.empty()) {
+        const Model::ExpressionData &expr = model.expression(pending.back());
+        pending.pop_back();
+        if (Operator::get(expr.op).isDecision())
+            continue;
+        for (ExpressionId op : expr.operands) {
+            if (!mapped[op.var()]) {
+                mapped[op.var()] = true;
+                pending.push_back(op.var());
+            }
+        }
+    }
+    vector<char> continuous(model.nbExpressions());
+    auto isInteger = [&](uint32_t var) {
+        return linearRows.isInteger(var) && !continuous[var];
+    };
+    bool changed = false;
+    for (const LinearRow &row : rows) {
+        if (row.removed || !row.isEquality())
+            continue;
+        for (size_t j = 0; j < row.vars.size(); ++j) {
+            uint32_t var = row.vars[j];
+            if (model.expression(var).op != UMO_OP_DEC_INT || mapped[var] ||
+                continuous[var] || bounds[var].isPoint())
+                continue;
+            // var = (rhs - sum(a_k * x_k)) / a_j
+            double a = row.coefs[j];
+            bool implied = isIntegral(row.lb / a);
+            for (size_t k = 0; k < row.vars.size() && implied; ++k) {
+                if (k == j)
+                    continue;
+                implied = isInteger(row.vars[k]) &&
+                          isIntegral(row.coefs[k] / a);
+            }
+            if (!implied)
+                continue;
+            continuous[var] = true;
+            changed = true;
+            break;
+        }
+    }
+    if (!changed)
+        return;
+    Rewriter rewriter(model);
+    PresolvedModel &newModel = rewriter.newModel();
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        if (!continuous[i])
+            continue;
+        ExpressionId lb = newModel.createConstant(bounds[i].lb);
+        ExpressionId ub = newModel.createConstant(bounds[i].ub);
+        rewriter.replace(i, newModel.createExpression(UMO_OP_DEC_FLOAT, {lb, ub}));
+    }
+    linearRows.rewriteDecisions(rewriter);
+    linearRows.rewriteRows(rewriter);
+    rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -0,0 +1,257 @@
+#include "presolve/linear_rows.hpp"
+
+#include "model/operator.hpp"
+
+#include <cmath>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+constexpr double LinearRows::feasibilityTolerance;
+
+Interval LinearRow::activity(const vector<Interval> &bounds) const {
+    Interval ret(0.0);
+    for (size_t j = 0; j < vars.size(); ++j) {
+        ret = ret + Interval(coefs[j]) * bounds[vars[j]];
+    }
+    return ret;
+}
+
+LinearRows::LinearRows(const PresolvedModel &model)
+    : model_(model), bounds_(model.nbExpressions()),
+      eliminated_(model.nbExpressions()) {
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        if (expr.op == UMO_OP_DEC_BOOL) {
+            bounds_[i] = Interval::boolean();
+        } else if (expr.op == UMO_OP_DEC_INT || expr.op == UMO_OP_DEC_FLOAT) {
+            bounds_[i] = Interval(model.getExpressionIdValue(expr.operands[0]),
+                                  model.getExpressionIdValue(expr.operands[1]));
+        }
+    }
+    for (ExpressionId c : model.constraints()) {
+        const Model::ExpressionData &expr = model.expression(c.var());
+        LinearRow row;
+        row.constraint = c.var();
+        row.lb = model.getExpressionIdValue(expr.operands[0]);
+        row.ub = model.getExpressionIdValue(expr.operands[1]);
+        row.removed = false;
+        row.modified = false;
+        unordered_map<uint32_t, size_t> index;
+        for (size_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
+            double coef = model.getExpressionIdValue(expr.operands[2 * j]);
+            uint32_t var = expr.operands[2 * j + 1].var();
+            auto it = index.find(var);
+            if (it != index.end()) {
+                // Same variable used twice in the row
+                row.coefs[it->second] += coef;
+                row.modified = true;
+                continue;
+            }
+            index.emplace(var, row.vars.size());
+            row.vars.push_back(var);
+            row.coefs.push_back(coef);
+        }
+        rows_.push_back(row);
+    }
+}
+
+bool LinearRows::valid(const PresolvedModel &model) {
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        switch (expr.op) {
+        case UMO_OP_INVALID:
+        case UMO_OP_CONSTANT:
+            continue;
+        case UMO_OP_DEC_BOOL:
+        case UMO_OP_DEC_INT:
+        case UMO_OP_DEC_FLOAT:
+            if (model.isConstraint(i))
+                return false;
+            continue;
+        case UMO_OP_LINEAR:
+            // Definitions of previously eliminated variables
+            if (model.isConstraint(i))
+                return false;
+            continue;
+        case UMO_OP_LINEARCOMP:
+            if (!model.isConstraintPos(i) || model.isConstraintNeg(i))
+                return false;
+            for (size_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
+                ExpressionId op = expr.operands[2 * j + 1];
+                if (op.isNot() || op.isMinus())
+                    return false;
+                if (!Operator::get(model.expression(op.var()).op).isDecision())
+                    return false;
+            }
+            continue;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LinearRows::isInteger(uint32_t var) const {
+    umo_operator op = model_.expression(var).op;
+    return op == UMO_OP_DEC_BOOL || op == UMO_OP_DEC_INT;
+}
+
+void LinearRows::rewriteDecisions(Rewriter &rewriter) const {
+    PresolvedModel &newModel = rewriter.newModel();
+    // Objectives must remain decisions for the writers
+    vector<char> inObjective(model_.nbExpressions());
+    for (const Model::ObjectiveData &obj : model_.objectives()) {
+        inObjective[obj.first.var()] = true;
+    }
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model_.expression(i);
+        if (!Operator::get(expr.op).isDecision() || eliminated_[i] ||
+            rewriter.replaced(i))
+            continue;
+        const Interval &bounds = bounds_[i];
+        if (bounds.isPoint() && !inObjective[i]) {
+            rewriter.replace(i, newModel.createConstant(bounds.lb));
+        } else if (bounds.isPoint() && expr.op == UMO_OP_DEC_BOOL) {
+            ExpressionId valId = newModel.createConstant(bounds.lb);
+            rewriter.replace(
+                i, newModel.createExpression(UMO_OP_DEC_INT, {valId, valId}));
+        } else if (expr.op != UMO_OP_DEC_BOOL &&
+                   bounds != Interval(model_.getExpressionIdValue(expr.operands[0]),
+                                      model_.getExpressionIdValue(expr.operands[1]))) {
+            ExpressionId lbId = newModel.createConstant(bounds.lb);
+            ExpressionId ubId = newModel.createConstant(bounds.ub);
+            rewriter.replace(i, newModel.createExpression(expr.op, {lbId, ubId}));
+        } else {
+            rewriter.copy(i);
+        }
+    }
+}
+
+void LinearRows::rewriteRows(Rewriter &rewriter) const {
+    PresolvedModel &newModel = rewriter.newModel();
+    for (const LinearRow &row : rows_) {
+        if (row.removed) {
+            rewriter.replace(row.constraint, newModel.createConstant(1.0));
+            continue;
+        }
+        // Remove the variables that became constants
+        vector<ExpressionId> operands;
+        operands.emplace_back();
+        operands.emplace_back();
+        double offset = 0.0;
+        bool modified = row.modified;
+        for (size_t j = 0; j < row.vars.size(); ++j) {
+            ExpressionId id = rewriter.get(ExpressionId::fromVar(row.vars[j]));
+            if (newModel.isConstant(id.var())) {
+                offset += row.coefs[j] * newModel.getExpressionIdValue(id);
+                modified = true;
+            } else {
+                operands.push_back(newModel.createConstant(row.coefs[j]));
+                operands.push_back(id);
+            }
+        }
+        if (!modified)
+            continue;
+        double lb = row.lb - offset;
+        double ub = row.ub - offset;
+        if (operands.size() == 2) {
+            double tol = feasibilityTolerance;
+            bool feasible = lb <= tol * max(1.0, abs(lb)) &&
+                            ub >= -tol * max(1.0, abs(ub));
+            rewriter.replace(row.constraint,
+                             newModel.createConstant(feasible ? 1.0 : 0.0));
+            continue;
+        }
+        operands[0] = newModel.createConstant(lb);
+        operands[1] = newModel.createConstant(ub);
+        rewriter.replace(row.constraint,
+                         newModel.createExpression(UMO_OP_LINEARCOMP, operands));
+    }
+    rewriteObjectives(rewriter);
+}
+
+void LinearRows::rewriteObjectives(Rewriter &rewriter) const {
+    PresolvedModel &newModel = rewriter.newModel();
+    for (const Model::ObjectiveData &obj : model_.objectives()) {
+        uint32_t var = obj.first.var();
+        if (model_.expression(var).op != UMO_OP_LINEAR || rewriter.replaced(var))
+            continue;
+        vector<double> coefs;
+        vector<ExpressionId> vars;
+        double constant = 0.0;
+        addObjectiveTerms(rewriter, ExpressionId::fromVar(var), 1.0, coefs, vars,
+                          constant);
+        // Merge the terms on the same variable
+        vector<ExpressionId> operands;
+        unordered_map<uint32_t, size_t> index;
+        for (size_t j = 0; j < vars.size(); ++j) {
+            auto it = index.find(vars[j].var());
+            if (it == index.end()) {
+                index.emplace(vars[j].var(), operands.size());
+                operands.push_back(newModel.createConstant(coefs[j]));
+                operands.push_back(vars[j]);
+            } else {
+                double coef = newModel.value(operands[it->second].var());
+                operands[it->second] = newModel.createConstant(coef + coefs[j]);
+            }
+        }
+        if (constant != 0.0) {
+            operands.push_back(newModel.createConstant(constant));
+            operands.push_back(newModel.createConstant(1.0));
+        }
+        rewriter.replace(var, newModel.createExpression(UMO_OP_LINEAR, operands));
+    }
+}
+
+void LinearRows::addObjectiveTerms(Rewriter &rewriter, ExpressionId id,
+                                   double coef, vector<double> &coefs,
+                                   vector<ExpressionId> &vars,
+                                   double &constant) const {
+    if (model_.isConstant(id.var())) {
+        constant += coef * model_.getExpressionIdValue(id);
+        return;
+    }
+    if (id.isMinus())
+        coef = -coef;
+    const Model::ExpressionData &expr = model_.expression(id.var());
+    if (expr.op == UMO_OP_LINEAR && !rewriter.replaced(id.var())) {
+        for (size_t j = 0; 2 * j + 1 < expr.operands.size(); ++j) {
+            double c = model_.getExpressionIdValue(expr.operands[2 * j]);
+            addObjectiveTerms(rewriter, expr.operands[2 * j + 1], coef * c,
+                              coefs, vars, constant);
+        }
+        return;
+    }
+    // Variables replaced by constants or by definitions over other variables
+    PresolvedModel &newModel = rewriter.newModel();
+    vector<pair<ExpressionId, double>> pending = {
+        make_pair(rewriter.get(ExpressionId::fromVar(id.var())), coef)};
+    while (!pending.empty()) {
+        ExpressionId newId = pending.back().first;
+        double c = pending.back().second;
+        pending.pop_back();
+        if (newModel.isConstant(newId.var())) {
+            constant += c * newModel.getExpressionIdValue(newId);
+            continue;
+        }
+        if (newId.isMinus())
+            c = -c;
+        const Model::ExpressionData &def = newModel.expression(newId.var());
+        if (def.op != UMO_OP_LINEAR) {
+            coefs.push_back(c);
+            vars.push_back(ExpressionId::fromVar(newId.var()));
+            continue;
+        }
+        for (size_t j = 0; 2 * j + 1 < def.operands.size(); ++j) {
+            double val = newModel.getExpressionIdValue(def.operands[2 * j]);
+            pending.emplace_back(def.operands[2 * j + 1], c * val);
+        }
+    }
+}
+
+} // namespace presolve
+} // namespace umoi
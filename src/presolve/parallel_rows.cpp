@@ -0,0 +1,124 @@
+#include "presolve/parallel_rows.hpp"
+
+#include "presolve/linear_rows.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+namespace {
+// Row with sorted variables and a first coefficient of one
+struct NormalizedRow {
+    vector<uint32_t> vars;
+    vector<double> coefs;
+    Interval bounds;
+    // Factor applied to the original row
+    double scale;
+};
+
+NormalizedRow normalize(const LinearRow &row) {
+    vector<size_t> order(row.vars.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(),
+         [&](size_t a, size_t b) { return row.vars[a] < row.vars[b]; });
+    NormalizedRow ret;
+    ret.scale = 1.0 / row.coefs[order[0]];
+    for (size_t j : order) {
+        ret.vars.push_back(row.vars[j]);
+        ret.coefs.push_back(row.coefs[j] * ret.scale);
+    }
+    ret.bounds = Interval(row.lb, row.ub) * Interval(ret.scale);
+    return ret;
+}
+
+size_t hashRow(const NormalizedRow &row) {
+    size_t h = row.vars.size();
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        // Coefficients are rounded so that numerical noise is ignored
+        long long coef = llround(row.coefs[j] * 1.0e6);
+        h ^= hash<uint32_t>()(row.vars[j]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= hash<long long>()(coef) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+bool isParallel(const NormalizedRow &a, const NormalizedRow &b) {
+    if (a.vars != b.vars)
+        return false;
+    for (size_t j = 0; j < a.coefs.size(); ++j) {
+        double tol = LinearRows::feasibilityTolerance *
+                     max(1.0, abs(a.coefs[j]));
+        if (abs(a.coefs[j] - b.coefs[j]) > tol)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+void ParallelRows::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    LinearRows linearRows(model);
+    vector<LinearRow> &rows = linearRows.rows();
+    vector<NormalizedRow> normalized(rows.size());
+    vector<char> merged(rows.size());
+    unordered_map<size_t, vector<uint32_t>> buckets;
+    buckets.reserve(rows.size());
+    bool changed = false;
+    for (uint32_t r = 0; r < rows.size(); ++r) {
+        if (rows[r].removed || rows[r].vars.empty())
+            continue;
+        normalized[r] = normalize(rows[r]);
+        vector<uint32_t> &bucket = buckets[hashRow(normalized[r])];
+        auto it = find_if(bucket.begin(), bucket.end(), [&](uint32_t q) {
+            return isParallel(normalized[q], normalized[r]);
+        });
+        if (it == bucket.end()) {
+            bucket.push_back(r);
+            continue;
+        }
+        // Merge with the first parallel row
+        Interval &bounds = normalized[*it].bounds;
+        Interval intersection = bounds.intersect(normalized[r].bounds);
+        if (intersection.empty()) {
+            double tol = LinearRows::feasibilityTolerance *
+                         max(1.0, max(abs(intersection.lb), abs(intersection.ub)));
+            if (intersection.lb - intersection.ub > tol) {
+                model.setInfeasible();
+                return;
+            }
+            intersection = Interval(0.5 * (intersection.lb + intersection.ub));
+        }
+        bounds = intersection;
+        merged[*it] = true;
+        rows[r].removed = true;
+        changed = true;
+    }
+    if (!changed)
+        return;
+    for (uint32_t r = 0; r < rows.size(); ++r) {
+        if (!merged[r])
+            continue;
+        // Back to the scale of the original row
+        Interval bounds =
+            normalized[r].bounds * Interval(1.0 / normalized[r].scale);
+        if (bounds.lb == rows[r].lb && bounds.ub == rows[r].ub)
+            continue;
+        rows[r].lb = bounds.lb;
+        rows[r].ub = bounds.ub;
+        rows[r].modified = true;
+    }
+    Rewriter rewriter(model);
+    linearRows.rewriteDecisions(rewriter);
+    linearRows.rewriteRows(rewriter);
+    rewriter.run();
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -1,13 +1,26 @@
 
 #include "presolve/presolve.hpp"
 
+#include "presolve/boolean_propagation.hpp"
+#include "presolve/bound_tightening.hpp"
+#include "presolve/cache.hpp"
 #include "presolve/cleanup.hpp"
+#include "presolve/clique_merging.hpp"
+#include "presolve/dual_reductions.hpp"
+#include "presolve/equality_substitution.hpp"
+#include "presolve/equivalent_literals.hpp"
 #include "presolve/flatten.hpp"
+#include "presolve/implied_integers.hpp"
+#include "presolve/parallel_rows.hpp"
 #include "presolve/propagate_constants.hpp"
+#include "presolve/row_presolve.hpp"
+#include "presolve/symmetry_breaking.hpp"
+#include "presolve/to_linear.hpp"
 
 #include "solver/external_solvers.hpp"
 
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -19,8 +32,38 @@ PresolvedModel run(Model &m) {
     Cleanup().run(model);
     Flatten().run(model);
     PropagateConstants().run(model);
+    BooleanPropagation().run(model);
+    EquivalentLiterals().run(model);
+    BoundTightening().run(model);
+    SymmetryBreaking().run(model);
     return model;
 }
 
+void linearize(PresolvedModel &model) {
+    // The encodings depend on the linearization parameters
+    stringstream stage;
+    stage << "linearize";
+    for (const char *param :
+         {"indicator_constraints", "xor_encoding", "piecewise_linear",
+          "linearization_target"}) {
+        stage << "-" << model.getStringParameter(param);
+    }
+    stage << "-" << model.getFloatParameter("piecewise_tolerance");
+    Cache cache(model, stage.str());
+    if (cache.find(model))
+        return;
+    ToLinear().run(model);
+    // The reductions below expect a linear model
+    if (!model.infeasible()) {
+        EqualitySubstitution().run(model);
+        ParallelRows().run(model);
+        RowPresolve().run(model);
+        CliqueMerging().run(model);
+        DualReductions().run(model);
+        ImpliedIntegers().run(model);
+    }
+    cache.insert(model);
+}
+
 } // namespace presolve
 } // namespace umoi
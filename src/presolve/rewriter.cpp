@@ -0,0 +1,77 @@
+#include "presolve/rewriter.hpp"
+
+#include "utils/utils.hpp"
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+Rewriter::Rewriter(PresolvedModel &model)
+    : model_(model), mapping_(model.nbExpressions()) {}
+
+void Rewriter::replace(uint32_t i, ExpressionId newId) { mapping_[i] = newId; }
+
+ExpressionId Rewriter::get(ExpressionId id) {
+    ExpressionId pid = mapping_[id.var()];
+    if (!pid.valid() && model_.isConstant(id.var()))
+        pid = copy(id.var());
+    if (!pid.valid())
+        THROW_ERROR("Expression " << id.var()
+                                  << " is used before being rewritten");
+    if (newModel_.isConstant(pid.var())) {
+        double val = newModel_.getExpressionIdValue(pid);
+        if (id.isNot())
+            val = 1.0 - val;
+        if (id.isMinus())
+            val = -val;
+        return newModel_.createConstant(val);
+    }
+    if (id.isNot() && pid.isMinus())
+        THROW_ERROR("Attempting to compose NOT and MINUS during presolve");
+    return ExpressionId(pid.var(), id.isNot() ^ pid.isNot(),
+                        id.isMinus() ^ pid.isMinus());
+}
+
+ExpressionId Rewriter::copy(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    ExpressionId newId;
+    if (expr.op == UMO_OP_CONSTANT) {
+        newId = newModel_.createConstant(model_.value(i));
+    } else {
+        vector<ExpressionId> operands;
+        operands.reserve(expr.operands.size());
+        for (ExpressionId op : expr.operands) {
+            operands.push_back(get(op));
+        }
+        newId = newModel_.createExpression(expr.op, operands);
+    }
+    mapping_[i] = newId;
+    return newId;
+}
+
+void Rewriter::run() {
+    for (uint32_t i = 0; i < model_.nbExpressions(); ++i) {
+        if (replaced(i) || model_.expression(i).op == UMO_OP_INVALID)
+            continue;
+        copy(i);
+    }
+    for (ExpressionId c : model_.constraints()) {
+        ExpressionId newId = get(c);
+        if (newModel_.isConstant(newId.var())) {
+            // Trivial constraint
+            if (newModel_.getExpressionIdValue(newId) == 0.0)
+                newModel_.setInfeasible();
+            continue;
+        }
+        newModel_.createConstraint(newId);
+    }
+    for (const Model::ObjectiveData &obj : model_.objectives()) {
+        newModel_.createObjective(get(obj.first), obj.second);
+    }
+    newModel_.mapping() = mapping_;
+    model_.apply(newModel_);
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -0,0 +1,207 @@
+#include "presolve/row_presolve.hpp"
+
+#include "presolve/linear_rows.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class RowPresolve::Reducer {
+  public:
+    Reducer(PresolvedModel &model);
+    bool run();
+    void rewrite();
+
+  private:
+    void presolveRow(LinearRow &row);
+    // Fix the variables of a forcing row to the bounds reaching its minimum
+    // or maximum activity
+    void forceRow(LinearRow &row, bool toMax);
+    void tightenCoefficients(LinearRow &row);
+    void tightenVariable(uint32_t var, Interval bounds);
+
+    // Comparisons up to the feasibility tolerance
+    bool leq(double a, double b) const {
+        return a <= b + tolerance * max(1.0, abs(b));
+    }
+    bool less(double a, double b) const {
+        return a < b - tolerance * max(1.0, abs(b));
+    }
+
+  private:
+    PresolvedModel &model;
+    LinearRows linearRows;
+    vector<LinearRow> &rows;
+    vector<Interval> &varBounds;
+
+    bool infeasible;
+    // Reductions found in the current round and since the beginning
+    bool changed;
+    bool reduced;
+
+    const int maxRounds = 20;
+    const double tolerance = LinearRows::feasibilityTolerance;
+};
+
+RowPresolve::Reducer::Reducer(PresolvedModel &model)
+    : model(model), linearRows(model), rows(linearRows.rows()),
+      varBounds(linearRows.bounds()), infeasible(false), changed(false),
+      reduced(false) {
+    for (const LinearRow &row : rows) {
+        if (row.modified)
+            reduced = true;
+    }
+}
+
+bool RowPresolve::Reducer::run() {
+    for (int round = 0; round < maxRounds; ++round) {
+        changed = false;
+        for (LinearRow &row : rows) {
+            presolveRow(row);
+            if (infeasible)
+                return false;
+        }
+        if (!changed)
+            break;
+        reduced = true;
+    }
+    return true;
+}
+
+void RowPresolve::Reducer::presolveRow(LinearRow &row) {
+    if (row.removed)
+        return;
+    Interval activity = row.activity(varBounds);
+    if (less(row.ub, activity.lb) || less(activity.ub, row.lb)) {
+        infeasible = true;
+        return;
+    }
+    if (leq(row.lb, activity.lb) && leq(activity.ub, row.ub)) {
+        // Redundant row
+        row.removed = true;
+        changed = true;
+        return;
+    }
+    if (row.vars.size() == 1) {
+        // Singleton row: bound on the variable
+        Interval bounds = Interval(row.lb, row.ub) / Interval(row.coefs[0]);
+        tightenVariable(row.vars[0], bounds);
+        row.removed = true;
+        changed = true;
+        return;
+    }
+    if (isfinite(row.lb) && leq(activity.ub, row.lb)) {
+        forceRow(row, true);
+        return;
+    }
+    if (isfinite(row.ub) && leq(row.ub, activity.lb)) {
+        forceRow(row, false);
+        return;
+    }
+    tightenCoefficients(row);
+}
+
+void RowPresolve::Reducer::forceRow(LinearRow &row, bool toMax) {
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        if (row.coefs[j] == 0.0)
+            continue;
+        uint32_t var = row.vars[j];
+        const Interval &bounds = varBounds[var];
+        bool atUpper = (row.coefs[j] > 0.0) == toMax;
+        tightenVariable(var, Interval(atUpper ? bounds.ub : bounds.lb));
+    }
+    row.removed = true;
+    changed = true;
+}
+
+void RowPresolve::Reducer::tightenCoefficients(LinearRow &row) {
+    // Only rows with a single finite side, written as sum(a * x) <= b
+    bool upper = isfinite(row.ub) && !isfinite(row.lb);
+    bool lower = isfinite(row.lb) && !isfinite(row.ub);
+    if (!upper && !lower)
+        return;
+    double sign = upper ? 1.0 : -1.0;
+    double b = upper ? row.ub : -row.lb;
+    Interval activity = row.activity(varBounds);
+    double maxActivity = upper ? activity.ub : -activity.lb;
+    if (!isfinite(maxActivity))
+        return;
+    for (size_t j = 0; j < row.vars.size(); ++j) {
+        uint32_t var = row.vars[j];
+        if (!linearRows.isInteger(var) || varBounds[var] != Interval::boolean())
+            continue;
+        double a = sign * row.coefs[j];
+        if (a > 0.0) {
+            // The row is redundant when the binary is zero: lower the
+            // coefficient and the right-hand side by the slack
+            double slack = b - (maxActivity - a);
+            if (slack <= tolerance * max(1.0, abs(b)) || slack >= a)
+                continue;
+            a -= slack;
+            b -= slack;
+            maxActivity -= slack;
+        } else {
+            // The row is redundant when the binary is one
+            double slack = b - a - maxActivity;
+            if (slack <= tolerance * max(1.0, abs(b)) || slack >= -a)
+                continue;
+            a += slack;
+        }
+        row.coefs[j] = sign * a;
+        row.modified = true;
+        changed = true;
+    }
+    if (upper)
+        row.ub = b;
+    else
+        row.lb = -b;
+}
+
+void RowPresolve::Reducer::tightenVariable(uint32_t var, Interval bounds) {
+    if (linearRows.isInteger(var))
+        bounds = bounds.roundInward();
+    Interval &cur = varBounds[var];
+    Interval tightened = cur;
+    // Ignore insignificant changes on continuous bounds
+    if (!isfinite(cur.lb) || less(cur.lb, bounds.lb))
+        tightened.lb = max(cur.lb, bounds.lb);
+    if (!isfinite(cur.ub) || less(bounds.ub, cur.ub))
+        tightened.ub = min(cur.ub, bounds.ub);
+    if (tightened.empty()) {
+        if (!leq(tightened.lb, tightened.ub) || linearRows.isInteger(var)) {
+            infeasible = true;
+            return;
+        }
+        // Numerical noise: collapse to a single value
+        tightened = Interval(0.5 * (tightened.lb + tightened.ub));
+    }
+    if (tightened != cur)
+        changed = true;
+    cur = tightened;
+}
+
+void RowPresolve::Reducer::rewrite() {
+    if (!reduced)
+        return;
+    Rewriter rewriter(model);
+    linearRows.rewriteDecisions(rewriter);
+    linearRows.rewriteRows(rewriter);
+    rewriter.run();
+}
+
+void RowPresolve::run(PresolvedModel &model) const {
+    if (!LinearRows::valid(model))
+        return;
+    Reducer reducer(model);
+    if (!reducer.run()) {
+        model.setInfeasible();
+        return;
+    }
+    reducer.rewrite();
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -0,0 +1,365 @@
+#include "presolve/symmetry_breaking.hpp"
+
+#include "model/operator.hpp"
+#include "utils/utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <set>
+
+using namespace std;
+
+namespace umoi {
+namespace presolve {
+
+class SymmetryBreaking::Graph {
+  public:
+    Graph(const PresolvedModel &model, double timeLimit);
+    vector<vector<uint32_t>> findGenerators();
+    // Whether the search was stopped by the time limit
+    bool timedOut() const { return timedOut_; }
+
+  private:
+    struct Edge {
+        uint32_t to;
+        uint64_t label;
+    };
+    typedef vector<uint32_t> Coloring;
+
+    void addOperandEdges(uint32_t i);
+    // Canonical numbering of arbitrary colors
+    static Coloring normalize(const vector<uint64_t> &colors);
+    // Refine to an equitable coloring; the result only depends on the graph
+    // and the initial colors, so that isomorphic inputs get the same colors
+    Coloring refine(const Coloring &colors) const;
+    Coloring individualize(const Coloring &colors, uint32_t v) const;
+    static bool sameCells(const Coloring &a, const Coloring &b);
+    // Try to find an automorphism mapping u to v
+    bool findMapping(const Coloring &base, uint32_t u, uint32_t v,
+                     vector<uint32_t> &perm) const;
+    bool isAutomorphism(const vector<uint32_t> &perm) const;
+    bool timeout() const {
+        if (chrono::steady_clock::now() > deadline_)
+            timedOut_ = true;
+        return timedOut_;
+    }
+
+  private:
+    const PresolvedModel &model_;
+    vector<uint64_t> vertexColors_;
+    vector<vector<Edge>> children_;
+    vector<vector<Edge>> parents_;
+    chrono::steady_clock::time_point deadline_;
+    mutable bool timedOut_;
+
+    // Number of candidates tried when individualizing a vertex
+    const size_t maxCandidates = 8;
+};
+
+namespace {
+uint64_t doubleBits(double val) {
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+bool isCommutative(umo_operator op) {
+    return Operator::get(op).isAssociative() || op == UMO_OP_CMP_EQ ||
+           op == UMO_OP_CMP_NEQ;
+}
+} // namespace
+
+SymmetryBreaking::Graph::Graph(const PresolvedModel &model, double timeLimit)
+    : model_(model), vertexColors_(model.nbExpressions()),
+      children_(model.nbExpressions()), parents_(model.nbExpressions()),
+      timedOut_(false) {
+    auto budget = chrono::duration<double>(max(0.0, timeLimit));
+    deadline_ = chrono::steady_clock::now() +
+                chrono::duration_cast<chrono::steady_clock::duration>(budget);
+    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = model.expression(i);
+        uint64_t color = hashCombine(expr.op, expr.type);
+        if (expr.op == UMO_OP_CONSTANT)
+            color = hashCombine(color, doubleBits(model.value(i)));
+        if (model.isConstraint(i)) {
+            color = hashCombine(color, model.isConstraintPos(i) ? 1 : 2);
+            color = hashCombine(color, model.isConstraintNeg(i) ? 1 : 2);
+        }
+        for (uint32_t o = 0; o < model.nbObjectives(); ++o) {
+            const Model::ObjectiveData &obj = model.objective(o);
+            if (obj.first.var() != i)
+                continue;
+            color = hashCombine(color, o);
+            color = hashCombine(color, obj.second);
+            color = hashCombine(color, obj.first.raw() & 0x03);
+        }
+        vertexColors_[i] = color;
+        addOperandEdges(i);
+    }
+}
+
+void SymmetryBreaking::Graph::addOperandEdges(uint32_t i) {
+    const Model::ExpressionData &expr = model_.expression(i);
+    const vector<ExpressionId> &ops = expr.operands;
+    auto addEdge = [&](ExpressionId op, uint64_t label) {
+        label = hashCombine(label, op.raw() & 0x03);
+        children_[i].push_back(Edge{op.var(), label});
+        parents_[op.var()].push_back(Edge{i, label});
+    };
+    if (expr.op == UMO_OP_LINEAR || expr.op == UMO_OP_LINEARCOMP) {
+        // Bounds are positional, and the coefficients label the terms
+        size_t first = expr.op == UMO_OP_LINEAR ? 0 : 1;
+        for (size_t j = 0; j < 2 * first; ++j) {
+            addEdge(ops[j], j + 1);
+        }
+        for (size_t j = first; 2 * j + 1 < ops.size(); ++j) {
+            uint64_t coef = doubleBits(model_.getExpressionIdValue(ops[2 * j]));
+            addEdge(ops[2 * j + 1], hashCombine(0, coef));
+        }
+    } else if (isCommutative(expr.op)) {
+        for (ExpressionId op : ops) {
+            addEdge(op, 0);
+        }
+    } else {
+        for (size_t j = 0; j < ops.size(); ++j) {
+            addEdge(ops[j], j + 1);
+        }
+    }
+}
+
+SymmetryBreaking::Graph::Coloring
+SymmetryBreaking::Graph::normalize(const vector<uint64_t> &colors) {
+    vector<uint64_t> sorted = colors;
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+    Coloring ret(colors.size());
+    for (size_t i = 0; i < colors.size(); ++i) {
+        ret[i] = lower_bound(sorted.begin(), sorted.end(), colors[i]) -
+                 sorted.begin();
+    }
+    return ret;
+}
+
+SymmetryBreaking::Graph::Coloring
+SymmetryBreaking::Graph::refine(const Coloring &colors) const {
+    Coloring cur = colors;
+    size_t nbColors = cur.empty() ? 0 : *max_element(cur.begin(), cur.end()) + 1;
+    while (true) {
+        map<vector<uint64_t>, uint32_t> signatures;
+        vector<vector<uint64_t>> sigs(cur.size());
+        for (uint32_t v = 0; v < cur.size(); ++v) {
+            vector<uint64_t> children;
+            for (const Edge &e : children_[v]) {
+                children.push_back(hashCombine(e.label, cur[e.to]));
+            }
+            vector<uint64_t> parents;
+            for (const Edge &e : parents_[v]) {
+                parents.push_back(hashCombine(e.label, cur[e.to]));
+            }
+            sort(children.begin(), children.end());
+            sort(parents.begin(), parents.end());
+            vector<uint64_t> &sig = sigs[v];
+            sig.push_back(cur[v]);
+            sig.push_back(children.size());
+            sig.insert(sig.end(), children.begin(), children.end());
+            sig.insert(sig.end(), parents.begin(), parents.end());
+            signatures.emplace(sig, 0);
+        }
+        uint32_t id = 0;
+        for (auto &s : signatures) {
+            s.second = id++;
+        }
+        Coloring next(cur.size());
+        for (uint32_t v = 0; v < cur.size(); ++v) {
+            next[v] = signatures[sigs[v]];
+        }
+        cur.swap(next);
+        if (signatures.size() == nbColors || timeout())
+            return cur;
+        nbColors = signatures.size();
+    }
+}
+
+SymmetryBreaking::Graph::Coloring
+SymmetryBreaking::Graph::individualize(const Coloring &colors,
+                                       uint32_t v) const {
+    // The individualized vertex gets a new color, after all others
+    Coloring ret = colors;
+    ret[v] = *max_element(colors.begin(), colors.end()) + 1;
+    return refine(ret);
+}
+
+bool SymmetryBreaking::Graph::sameCells(const Coloring &a, const Coloring &b) {
+    vector<uint32_t> sizesA;
+    vector<uint32_t> sizesB;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] >= sizesA.size())
+            sizesA.resize(a[i] + 1);
+        if (b[i] >= sizesB.size())
+            sizesB.resize(b[i] + 1);
+        ++sizesA[a[i]];
+        ++sizesB[b[i]];
+    }
+    return sizesA == sizesB;
+}
+
+bool SymmetryBreaking::Graph::findMapping(const Coloring &base, uint32_t u,
+                                          uint32_t v,
+                                          vector<uint32_t> &perm) const {
+    Coloring c1 = individualize(base, u);
+    Coloring c2 = individualize(base, v);
+    while (sameCells(c1, c2) && !timeout()) {
+        // First non-singleton cell
+        vector<uint32_t> sizes;
+        for (uint32_t c : c1) {
+            if (c >= sizes.size())
+                sizes.resize(c + 1);
+            ++sizes[c];
+        }
+        uint32_t cell = 0;
+        while (cell < sizes.size() && sizes[cell] <= 1)
+            ++cell;
+        if (cell == sizes.size()) {
+            // Discrete colorings: the mapping is given by the colors
+            vector<uint32_t> byColor(c2.size());
+            for (uint32_t x = 0; x < c2.size(); ++x) {
+                byColor[c2[x]] = x;
+            }
+            perm.resize(c1.size());
+            for (uint32_t x = 0; x < c1.size(); ++x) {
+                perm[x] = byColor[c1[x]];
+            }
+            return isAutomorphism(perm);
+        }
+        uint32_t w1 = find(c1.begin(), c1.end(), cell) - c1.begin();
+        Coloring next1 = individualize(c1, w1);
+        bool found = false;
+        size_t nbTried = 0;
+        for (uint32_t w2 = 0; w2 < c2.size() && nbTried < maxCandidates;
+             ++w2) {
+            if (c2[w2] != cell)
+                continue;
+            ++nbTried;
+            Coloring next2 = individualize(c2, w2);
+            if (sameCells(next1, next2)) {
+                c1.swap(next1);
+                c2.swap(next2);
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return false;
+}
+
+bool SymmetryBreaking::Graph::isAutomorphism(
+    const vector<uint32_t> &perm) const {
+    for (uint32_t x = 0; x < perm.size(); ++x) {
+        uint32_t y = perm[x];
+        if (vertexColors_[x] != vertexColors_[y] ||
+            children_[x].size() != children_[y].size())
+            return false;
+        vector<pair<uint64_t, uint32_t>> mapped;
+        vector<pair<uint64_t, uint32_t>> target;
+        for (const Edge &e : children_[x]) {
+            mapped.emplace_back(e.label, perm[e.to]);
+        }
+        for (const Edge &e : children_[y]) {
+            target.emplace_back(e.label, e.to);
+        }
+        sort(mapped.begin(), mapped.end());
+        sort(target.begin(), target.end());
+        if (mapped != target)
+            return false;
+    }
+    return true;
+}
+
+vector<vector<uint32_t>> SymmetryBreaking::Graph::findGenerators() {
+    vector<vector<uint32_t>> generators;
+    Coloring base = refine(normalize(vertexColors_));
+    // Orbits of the group generated so far
+    vector<uint32_t> orbit(base.size());
+    for (uint32_t i = 0; i < orbit.size(); ++i) {
+        orbit[i] = i;
+    }
+    auto findOrbit = [&](uint32_t x) {
+        while (orbit[x] != x)
+            x = orbit[x] = orbit[orbit[x]];
+        return x;
+    };
+    map<uint32_t, vector<uint32_t>> cells;
+    for (uint32_t i = 0; i < base.size(); ++i) {
+        if (model_.isDecision(i))
+            cells[base[i]].push_back(i);
+    }
+    for (const auto &cell : cells) {
+        const vector<uint32_t> &vertices = cell.second;
+        uint32_t u = vertices[0];
+        for (size_t k = 1; k < vertices.size(); ++k) {
+            if (timeout())
+                return generators;
+            uint32_t v = vertices[k];
+            if (findOrbit(u) == findOrbit(v))
+                continue;
+            vector<uint32_t> perm;
+            if (!findMapping(base, u, v, perm))
+                continue;
+            for (uint32_t x = 0; x < perm.size(); ++x) {
+                orbit[findOrbit(x)] = findOrbit(perm[x]);
+            }
+            generators.push_back(perm);
+        }
+    }
+    return generators;
+}
+
+vector<vector<uint32_t>>
+SymmetryBreaking::generators(const PresolvedModel &model,
+                             double timeLimit, bool *timedOut) const {
+    Graph graph(model, timeLimit);
+    vector<vector<uint32_t>> ret = graph.findGenerators();
+    if (timedOut)
+        *timedOut = graph.timedOut();
+    return ret;
+}
+
+void SymmetryBreaking::run(PresolvedModel &model) const {
+    const string &param = model.getStringParameter("symmetry_breaking");
+    if (param != "on" && param != "off")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid symmetry_breaking parameter");
+    if (param == "off")
+        return;
+    double timeLimit = model.getFloatParameter("symmetry_time_limit");
+    bool timedOut = false;
+    vector<vector<uint32_t>> perms = generators(model, timeLimit, &timedOut);
+    // Other runs may find other generators
+    if (timedOut)
+        model.setTimeLimited();
+    set<pair<uint32_t, uint32_t>> added;
+    for (const vector<uint32_t> &perm : perms) {
+        // First decision moved by the generator, in the order of the model
+        uint32_t i = 0;
+        while (i < perm.size() && (perm[i] == i || !model.isDecision(i)))
+            ++i;
+        if (i == perm.size() || !added.emplace(i, perm[i]).second)
+            continue;
+        // x_i >= x_perm(i)
+        ExpressionId xi = ExpressionId::fromVar(i);
+        ExpressionId xj = ExpressionId::fromVar(perm[i]);
+        if (model.expression(i).op == UMO_OP_DEC_BOOL)
+            model.createConstraint(
+                model.createExpression(UMO_OP_OR, {xi, xj.getNot()}));
+        else
+            model.createConstraint(
+                model.createExpression(UMO_OP_CMP_GEQ, {xi, xj}));
+    }
+}
+
+} // namespace presolve
+} // namespace umoi
@@ -1,33 +1,67 @@
 
 #include "presolve/to_linear.hpp"
 #include "model/operator.hpp"
+#include "presolve/bound_tightening.hpp"
+#include "presolve/incremental.hpp"
 #include "utils/utils.hpp"
 
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std;
 
 namespace umoi {
 namespace presolve {
 
+namespace {
+bool isQuadraticTerm(const PresolvedModel &model, uint32_t i);
+} // namespace
+
 class ToLinear::Transformer {
   public:
     Transformer(PresolvedModel &);
     void run();
 
+    // Reuse the previous transformation if the model only grew since
+    bool restore();
+    // Keep the transformation for the next solve and apply it to the model
+    void save();
+
+    // Find the linear expressions with a single use in a row, that are
+    // expanded in that row instead of getting their own variable
+    void findInlined();
+    bool isInlined(uint32_t i) const { return i < inlined.size() && inlined[i]; }
+    // Products of two variables kept as quadratic terms
+    bool isQuadratic(uint32_t i) const {
+        return quadratic && isQuadraticTerm(model, i);
+    }
+
     void createExpressions();
     void createObjectives();
     void linearizeExpressions();
+    // Enforce expressions that became constraints since the previous
+    // transformation
+    void linearizeNewConstraints();
 
     void linearize(uint32_t i);
 
     void linearizeSum(uint32_t i);
     void linearizeProd(uint32_t i);
     void linearizeCompare(uint32_t i);
+    void linearizeReifiedCompare(uint32_t i);
     void linearizeAnd(uint32_t i);
     void linearizeOr(uint32_t i);
     void linearizeXor(uint32_t i);
+    void linearizeMinMax(uint32_t i);
+    void linearizeAbs(uint32_t i);
+    void linearizeDivMod(uint32_t i);
+    void linearizeRounding(uint32_t i);
+    void linearizeSign(uint32_t i);
+    void linearizePiecewise(uint32_t i);
     void copyExpression(uint32_t i);
 
     void linearizeConstrainedEq(ExpressionId op1, ExpressionId op2);
@@ -35,13 +69,28 @@ class ToLinear::Transformer {
                                   double margin);
     void linearizeConstrainedLeq(ExpressionId op1, ExpressionId op2);
     void linearizeConstrainedLt(ExpressionId op1, ExpressionId op2);
+    void linearizeConstrainedNeq(ExpressionId op1, ExpressionId op2);
 
     // Helper function: get affine coefficients for a compressed (not/minus)
     // expression
     Element getElement(ExpressionId expr, bool useOriginalId=true) const;
+    // Helper function: append the affine terms of a compressed expression,
+    // expanding the inlined expressions
+    void addTerms(ExpressionId expr, double coef, vector<double> &coefs,
+                  vector<Element> &elements) const;
     // Helper function: get ExpressionId for a compressed (not/minus) expression
     ExpressionId getExpressionId(ExpressionId expr);
 
+    // Helper function: append the (coefficient, variable) pairs of a linear
+    // expression to the operands, and return its constant offset
+    double addOperands(const vector<double> &coefs,
+                       const vector<Element> &elements,
+                       vector<ExpressionId> &operands);
+    // Helper function: row expression, or a constant if the row is trivially
+    // satisfied or violated
+    ExpressionId makeRow(const vector<double> &coefs,
+                         const vector<Element> &operands, double lb,
+                         double ub);
     // Helper function: direct expression of a constraint
     void makeConstraint(const vector<double> &coefs,
                         const vector<ExpressionId> &operands, double lb,
@@ -55,11 +104,64 @@ class ToLinear::Transformer {
                         double lb, double ub);
     // Helper function: constrain variable i to be equal to factor * op
     void constrainToProd(uint32_t i, ExpressionId op, double factor);
+    // Helper function: new boolean variable equal to the conjunction of the
+    // operands
+    Element makeAnd(const vector<ExpressionId> &operands);
+    // Helper function: constrain prod = cond * op, for a boolean condition and
+    // a bounded operand
+    void constrainBoolProd(Element prod, Element cond, ExpressionId op);
+    // Helper function: enforce lb <= sum(coefs * ops) <= ub when the boolean
+    // condition is true, with an indicator constraint or a big-M term
+    void makeImplication(Element cond, const vector<double> &coefs,
+                         const vector<ExpressionId> &ops, double lb,
+                         double ub);
+    // Helper function: constrain op1 != op2 unless the literal eq is true
+    void constrainNotEqual(Element eq, ExpressionId op1, ExpressionId op2);
+    // Helper function: boolean true if and only if the expression is
+    // nonnegative, or a constant if its sign is known
+    Element makeSign(ExpressionId op);
+    // Helper function: smallest difference between unequal operands
+    double strictMargin(ExpressionId op1, ExpressionId op2) const;
+    // Helper function: product node of the variables of a quadratic term
+    ExpressionId createQuadratic(uint32_t i);
+    // Helper function: bounds of a compressed expression after bound tightening
+    Interval getBounds(ExpressionId expr) const;
+    // Helper function: create an auxiliary variable for expression i, with
+    // the tightest known bounds
+    ExpressionId createAuxiliary(uint32_t i, umo_operator op);
 
   private:
     PresolvedModel &model;
     PresolvedModel linearModel;
 
+    // Bounds of the original expressions after bound tightening
+    vector<Interval> bounds;
+
+    // State kept between solves, or null if not incremental
+    shared_ptr<IncrementalState> state;
+    // First expression not handled by the previous transformation
+    uint32_t first;
+    // Previous expressions that became constraints since
+    vector<uint32_t> newConstraints;
+    // Expressions expanded in the row that uses them
+    vector<char> inlined;
+    // Directions in which the value of each expression may help
+    vector<char> preferLarger;
+    vector<char> preferSmaller;
+    // Expressions linearized with a one-sided relaxation, and the direction
+    // in which their value may differ from the exact one
+    vector<char> relaxed;
+    // Whether implications are written as indicator constraints
+    bool indicators;
+    // Encoding of XOR expressions: "auto", "chain" or "parity"
+    string xorEncoding;
+    // Whether nonlinear univariate expressions are approximated by piecewise
+    // linear functions, and the maximum error of the approximation
+    bool piecewise;
+    double piecewiseTolerance;
+    // Whether products of two variables are kept for a quadratic solver
+    bool quadratic;
+
     ExpressionId constantMInf;
     ExpressionId constantPInf;
     ExpressionId constantZero;
@@ -67,6 +169,10 @@ class ToLinear::Transformer {
     ExpressionId constantMOne;
 
     const double strictEqualityMargin = 1.0e-6;
+    // Largest XOR written as a chain in the "auto" encoding; the chain has a
+    // tighter relaxation but grows by one boolean and four rows per operand
+    const size_t maxChainedXorArity = 3;
+    const double auxiliaryBoundMargin = 1.0e-6;
 };
 
 struct ToLinear::Element {
@@ -75,7 +181,325 @@ struct ToLinear::Element {
     double constant;
 };
 
-ToLinear::Transformer::Transformer(PresolvedModel &model) : model(model) {
+// Last transformation of a model, with the parameters it depends on
+struct LinearSnapshot {
+    PresolvedModel input;
+    PresolvedModel output;
+    vector<Interval> bounds;
+    vector<char> inlined;
+    vector<char> relaxed;
+    bool indicators;
+    string xorEncoding;
+    bool piecewise;
+    double piecewiseTolerance;
+    bool quadratic;
+};
+
+namespace {
+int countNonConstantOperands(const PresolvedModel &model, const Model::ExpressionData &expr) {
+    int nbNonConstant = 0;
+    for (ExpressionId id : expr.operands) {
+        if (!model.isConstant(id.var())) {
+            ++nbNonConstant;
+        }
+    }
+    return nbNonConstant;
+}
+
+// Expressions that contribute a linear combination of their operands
+bool isLinearExpression(const PresolvedModel &model, uint32_t i) {
+    const Model::ExpressionData &expr = model.expression(i);
+    if (expr.op == UMO_OP_SUM)
+        return true;
+    return expr.op == UMO_OP_PROD && countNonConstantOperands(model, expr) <= 1;
+}
+
+// Directions in which the value of each expression may help the
+// constraints or the objective. An expression that never benefits from a
+// larger value can be replaced by an upper estimate, and conversely.
+void computeDirections(const PresolvedModel &model, vector<char> &preferLarger,
+                       vector<char> &preferSmaller) {
+    uint32_t n = model.nbExpressions();
+    preferLarger.assign(n, false);
+    preferSmaller.assign(n, false);
+    auto mark = [&](ExpressionId id, bool larger, bool smaller) {
+        if (id.isMinus() != id.isNot())
+            swap(larger, smaller);
+        preferLarger[id.var()] |= larger;
+        preferSmaller[id.var()] |= smaller;
+    };
+    for (const Model::ObjectiveData &obj : model.objectives()) {
+        bool maximize = obj.second == UMO_OBJ_MAXIMIZE;
+        mark(obj.first, maximize, !maximize);
+    }
+    for (uint32_t i = n; i > 0; --i) {
+        const Model::ExpressionData &expr = model.expression(i - 1);
+        // Constraints prefer to be true
+        bool larger = preferLarger[i - 1] || model.isConstraintPos(i - 1);
+        bool smaller = preferSmaller[i - 1] || model.isConstraintNeg(i - 1);
+        if (!larger && !smaller)
+            continue;
+        const vector<ExpressionId> &ops = expr.operands;
+        switch (expr.op) {
+        case UMO_OP_SUM:
+        case UMO_OP_MIN:
+        case UMO_OP_MAX:
+        case UMO_OP_AND:
+        case UMO_OP_OR:
+            // Increasing in all operands
+            for (ExpressionId op : ops) {
+                mark(op, larger, smaller);
+            }
+            break;
+        case UMO_OP_CMP_LEQ:
+        case UMO_OP_CMP_LT:
+            mark(ops[0], smaller, larger);
+            mark(ops[1], larger, smaller);
+            break;
+        case UMO_OP_CMP_GEQ:
+        case UMO_OP_CMP_GT:
+            mark(ops[0], larger, smaller);
+            mark(ops[1], smaller, larger);
+            break;
+        case UMO_OP_PROD: {
+            if (countNonConstantOperands(model, expr) > 1) {
+                for (ExpressionId op : ops) {
+                    mark(op, true, true);
+                }
+                break;
+            }
+            double factor = 1.0;
+            for (ExpressionId op : ops) {
+                if (model.isConstant(op.var()))
+                    factor *= model.getExpressionIdValue(op);
+            }
+            for (ExpressionId op : ops) {
+                if (factor >= 0.0)
+                    mark(op, larger, smaller);
+                if (factor <= 0.0)
+                    mark(op, smaller, larger);
+            }
+            break;
+        }
+        case UMO_OP_LINEAR:
+            for (size_t j = 0; 2 * j + 1 < ops.size(); ++j) {
+                double coef = model.getExpressionIdValue(ops[2 * j]);
+                if (coef >= 0.0)
+                    mark(ops[2 * j + 1], larger, smaller);
+                if (coef <= 0.0)
+                    mark(ops[2 * j + 1], smaller, larger);
+            }
+            break;
+        case UMO_OP_LINEARCOMP: {
+            // A true row prefers a smaller activity if its upper bound is
+            // finite, and a larger one if its lower bound is finite
+            bool up = smaller || isfinite(model.getExpressionIdValue(ops[0]));
+            bool down = smaller || isfinite(model.getExpressionIdValue(ops[1]));
+            for (size_t j = 1; 2 * j + 1 < ops.size(); ++j) {
+                double coef = model.getExpressionIdValue(ops[2 * j]);
+                if (coef >= 0.0)
+                    mark(ops[2 * j + 1], up, down);
+                if (coef <= 0.0)
+                    mark(ops[2 * j + 1], down, up);
+            }
+            break;
+        }
+        default:
+            // Not monotone, or not analyzed
+            for (ExpressionId op : ops) {
+                mark(op, true, true);
+            }
+        }
+    }
+}
+
+// Whether a MIN, MAX or ABS expression only needs a one-sided relaxation
+bool isRelaxable(umo_operator op, bool preferLarger, bool preferSmaller) {
+    if (op == UMO_OP_MIN)
+        return !preferSmaller;
+    return !preferLarger;
+}
+
+// Directions of the relaxations
+const char relaxedAbove = 1;
+const char relaxedBelow = 2;
+
+bool useIndicators(const PresolvedModel &model) {
+    const string &param = model.getStringParameter("indicator_constraints");
+    if (param != "on" && param != "off")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid indicator_constraints "
+                            "parameter");
+    return param == "on";
+}
+
+bool usePiecewise(const PresolvedModel &model) {
+    const string &param = model.getStringParameter("piecewise_linear");
+    if (param != "on" && param != "off")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid piecewise_linear parameter");
+    return param == "on";
+}
+
+// Largest number of breakpoints of a piecewise linear approximation
+const size_t maxBreakpoints = 1000;
+
+// Nonlinear expressions of a single variable operand, that may be
+// approximated by a piecewise linear function
+bool isPiecewiseLinearizable(const PresolvedModel &model, uint32_t i) {
+    const Model::ExpressionData &expr = model.expression(i);
+    switch (expr.op) {
+    case UMO_OP_SQRT:
+    case UMO_OP_SQUARE:
+    case UMO_OP_INV:
+    case UMO_OP_EXP:
+    case UMO_OP_LOG:
+    case UMO_OP_COS:
+    case UMO_OP_SIN:
+    case UMO_OP_TAN:
+    case UMO_OP_COSH:
+    case UMO_OP_SINH:
+    case UMO_OP_TANH:
+    case UMO_OP_ACOS:
+    case UMO_OP_ASIN:
+    case UMO_OP_ATAN:
+    case UMO_OP_ACOSH:
+    case UMO_OP_ASINH:
+    case UMO_OP_ATANH:
+    case UMO_OP_POW:
+    case UMO_OP_LOGB:
+        return countNonConstantOperands(model, expr) == 1;
+    default:
+        return false;
+    }
+}
+
+// Value of a piecewise linearizable expression for a value of its variable
+double evaluateUnivariate(const PresolvedModel &model, uint32_t i, double t) {
+    const Model::ExpressionData &expr = model.expression(i);
+    vector<double> values;
+    for (ExpressionId op : expr.operands) {
+        values.push_back(model.isConstant(op.var())
+                             ? model.getExpressionIdValue(op)
+                             : t);
+    }
+    return Operator::get(expr.op).compute(values.size(), values.data());
+}
+
+// Breakpoints of a piecewise linear approximation of expression i over the
+// domain of its variable, within the tolerance; false if the function is
+// not finite on the domain or needs too many breakpoints. Integer
+// variables get integer breakpoints, and every value of a small domain.
+bool computeBreakpoints(const PresolvedModel &model, uint32_t i,
+                        Interval domain, bool integer, double tolerance,
+                        vector<double> &points, vector<double> &values) {
+    points.clear();
+    values.clear();
+    if (!domain.isFinite() || domain.empty())
+        return false;
+    auto f = [&](double t) { return evaluateUnivariate(model, i, t); };
+    if (integer && domain.ub - domain.lb < maxBreakpoints) {
+        for (double t = domain.lb; t <= domain.ub; t += 1.0) {
+            points.push_back(t);
+        }
+    } else if (model.expression(i).type != UMO_TYPE_FLOAT) {
+        // Integer results are only exact with every value as a breakpoint
+        return false;
+    } else {
+        // Bisect the segments until the chords are close enough to the
+        // function on a few sample points
+        vector<pair<double, double>> segments = {{domain.lb, domain.ub}};
+        points.push_back(domain.lb);
+        while (!segments.empty()) {
+            double a = segments.back().first;
+            double b = segments.back().second;
+            segments.pop_back();
+            double fa = f(a);
+            double fb = f(b);
+            double error = 0.0;
+            const int nbSamples = 8;
+            for (int k = 1; k < nbSamples; ++k) {
+                double t = a + (b - a) * k / nbSamples;
+                double chord = fa + (fb - fa) * k / nbSamples;
+                error = max(error, abs(f(t) - chord));
+            }
+            double mid = integer ? floor((a + b) / 2.0) : (a + b) / 2.0;
+            if (!(error <= tolerance) && mid > a && mid < b) {
+                if (points.size() + segments.size() >= maxBreakpoints)
+                    return false;
+                segments.emplace_back(mid, b);
+                segments.emplace_back(a, mid);
+            } else {
+                points.push_back(b);
+            }
+        }
+    }
+    for (double t : points) {
+        values.push_back(f(t));
+        if (!isfinite(values.back()))
+            return false;
+    }
+    return true;
+}
+
+bool useQuadratic(const PresolvedModel &model) {
+    const string &param = model.getStringParameter("linearization_target");
+    if (param != "linear" && param != "quadratic")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid linearization_target parameter");
+    return param == "quadratic";
+}
+
+// Square or product of two non-boolean variables
+bool isQuadraticShape(const PresolvedModel &model, uint32_t i) {
+    const Model::ExpressionData &expr = model.expression(i);
+    int nbVariables = 0;
+    for (ExpressionId op : expr.operands) {
+        if (model.isConstant(op.var()))
+            continue;
+        if (model.expression(op.var()).type == UMO_TYPE_BOOL)
+            return false;
+        ++nbVariables;
+    }
+    switch (expr.op) {
+    case UMO_OP_SQUARE:
+        return nbVariables == 1;
+    case UMO_OP_POW:
+        return nbVariables == 1 && model.isConstant(expr.operands[1].var()) &&
+               model.getExpressionIdValue(expr.operands[1]) == 2.0;
+    case UMO_OP_PROD:
+        return nbVariables == 2;
+    default:
+        return false;
+    }
+}
+
+// Quadratic term whose variables are not quadratic terms themselves
+bool isQuadraticTerm(const PresolvedModel &model, uint32_t i) {
+    if (!isQuadraticShape(model, i))
+        return false;
+    for (ExpressionId op : model.expression(i).operands) {
+        if (isQuadraticShape(model, op.var()))
+            return false;
+    }
+    return true;
+}
+
+string xorEncodingParameter(const PresolvedModel &model) {
+    const string &param = model.getStringParameter("xor_encoding");
+    if (param != "auto" && param != "chain" && param != "parity")
+        THROW_ERROR("\"" << param
+                         << "\" is not a valid xor_encoding parameter");
+    return param;
+}
+} // namespace
+
+ToLinear::Transformer::Transformer(PresolvedModel &model)
+    : model(model), state(incrementalStateOf(model)), first(0),
+      indicators(useIndicators(model)),
+      xorEncoding(xorEncodingParameter(model)), piecewise(usePiecewise(model)),
+      piecewiseTolerance(model.getFloatParameter("piecewise_tolerance")),
+      quadratic(useQuadratic(model)) {
     constantMInf =
         linearModel.createConstant(-numeric_limits<double>::infinity());
     constantPInf =
@@ -85,19 +509,125 @@ ToLinear::Transformer::Transformer(PresolvedModel &model) : model(model) {
     constantMOne = linearModel.createConstant(-1.0);
 }
 
+bool ToLinear::Transformer::restore() {
+    if (!state)
+        return false;
+    shared_ptr<LinearSnapshot> snapshot;
+    {
+        // The snapshot is taken over, and replaced after the transformation
+        lock_guard<mutex> lock(state->mutex);
+        snapshot = move(state->linear);
+    }
+    if (!snapshot || !model.extends(snapshot->input) ||
+        snapshot->indicators != indicators ||
+        snapshot->xorEncoding != xorEncoding ||
+        snapshot->piecewise != piecewise ||
+        snapshot->piecewiseTolerance != piecewiseTolerance ||
+        snapshot->quadratic != quadratic)
+        return false;
+    const PresolvedModel &prev = snapshot->input;
+    vector<uint32_t> constrained;
+    for (uint32_t i = 0; i < prev.nbExpressions(); ++i) {
+        if (model.isConstraintPos(i) == prev.isConstraintPos(i) &&
+            model.isConstraintNeg(i) == prev.isConstraintNeg(i))
+            continue;
+        // Only boolean gates and decisions are enforced afterwards
+        const auto &expr = model.expression(i);
+        if (prev.isConstraint(i) || Operator::get(expr.op).isComparison() ||
+            expr.op == UMO_OP_LINEARCOMP || expr.op == UMO_OP_CONSTANT ||
+            (model.isConstraintPos(i) && model.isConstraintNeg(i)))
+            return false;
+        constrained.push_back(i);
+    }
+    // Relaxations must remain valid with the new constraints
+    for (uint32_t i = 0; i < prev.nbExpressions(); ++i) {
+        if ((snapshot->relaxed[i] & relaxedAbove) && preferLarger[i])
+            return false;
+        if ((snapshot->relaxed[i] & relaxedBelow) && preferSmaller[i])
+            return false;
+    }
+    // Inlined expressions have no variable to be used by the new ones
+    for (uint32_t i = prev.nbExpressions(); i < model.nbExpressions(); ++i) {
+        for (ExpressionId op : model.expression(i).operands) {
+            if (op.var() < prev.nbExpressions() && snapshot->inlined[op.var()])
+                return false;
+        }
+    }
+    linearModel = move(snapshot->output);
+    bounds = move(snapshot->bounds);
+    inlined = move(snapshot->inlined);
+    relaxed = move(snapshot->relaxed);
+    first = prev.nbExpressions();
+    newConstraints = constrained;
+    lock_guard<mutex> lock(state->mutex);
+    ++state->nbLinearReused;
+    return true;
+}
+
+void ToLinear::Transformer::save() {
+    if (!state) {
+        model.apply(linearModel);
+        return;
+    }
+    shared_ptr<LinearSnapshot> next = make_shared<LinearSnapshot>();
+    next->input = model;
+    next->output = move(linearModel);
+    next->bounds = move(bounds);
+    next->inlined = move(inlined);
+    next->relaxed = move(relaxed);
+    next->indicators = indicators;
+    next->xorEncoding = xorEncoding;
+    next->piecewise = piecewise;
+    next->piecewiseTolerance = piecewiseTolerance;
+    next->quadratic = quadratic;
+    model.apply(next->output);
+    lock_guard<mutex> lock(state->mutex);
+    state->linear = move(next);
+}
+
+void ToLinear::Transformer::findInlined() {
+    uint32_t n = model.nbExpressions();
+    // Number of uses of each expression, and its last user
+    vector<uint32_t> nbUses(n);
+    vector<uint32_t> user(n);
+    for (uint32_t i = first; i < n; ++i) {
+        for (ExpressionId op : model.expression(i).operands) {
+            ++nbUses[op.var()];
+            user[op.var()] = i;
+        }
+    }
+    inlined.resize(n);
+    for (uint32_t i = first; i < n; ++i) {
+        if (model.isConstraint(i) || !isLinearExpression(model, i))
+            continue;
+        if (nbUses[i] == 0 && model.isObjective(i)) {
+            // Expanded in the linear objective
+            inlined[i] = true;
+            continue;
+        }
+        if (nbUses[i] != 1 || model.isObjective(i))
+            continue;
+        // The user must build its rows from the terms of its operands
+        uint32_t u = user[i];
+        umo_operator op = model.expression(u).op;
+        inlined[i] = isLinearExpression(model, u) ||
+                     (Operator::get(op).isComparison() && model.isConstraint(u));
+    }
+}
+
 void ToLinear::Transformer::createExpressions() {
     // Copy expressions
-    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+    for (uint32_t i = first; i < model.nbExpressions(); ++i) {
         const auto &expr = model.expression(i);
         if (expr.op == UMO_OP_INVALID)
             continue;
-        if (expr.op == UMO_OP_CONSTANT)
+        if (expr.op == UMO_OP_CONSTANT || isInlined(i))
             continue;
         if (model.isConstraint(i)) {
             if (!model.isConstraintPos(i)) {
-                linearModel.mapping().emplace(i, constantZero);
+                linearModel.setMapping(i, constantZero);
             } else if (!model.isConstraintNeg(i)) {
-                linearModel.mapping().emplace(i, constantPOne);
+                linearModel.setMapping(i, constantPOne);
             } else {
                 throw runtime_error(
                     "Inconsistent opposite constraints are not supported yet");
@@ -114,7 +644,10 @@ void ToLinear::Transformer::createExpressions() {
                     model.getExpressionIdValue(expr.operands[1]));
                 newId = linearModel.createExpression(expr.op, {lb, ub});
             }
-            linearModel.mapping().emplace(i, newId);
+            linearModel.setMapping(i, newId);
+        } else if (isQuadratic(i)) {
+            // Written directly in the rows that use it
+            linearModel.setMapping(i, createQuadratic(i));
         } else {
             ExpressionId newId;
             switch (expr.type) {
@@ -122,39 +655,87 @@ void ToLinear::Transformer::createExpressions() {
                 newId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
                 break;
             case UMO_TYPE_INT:
-                newId = linearModel.createExpression(
-                    UMO_OP_DEC_INT, {constantMInf, constantPInf});
+                newId = createAuxiliary(i, UMO_OP_DEC_INT);
                 break;
             case UMO_TYPE_FLOAT:
-                newId = linearModel.createExpression(
-                    UMO_OP_DEC_FLOAT, {constantMInf, constantPInf});
+                newId = createAuxiliary(i, UMO_OP_DEC_FLOAT);
                 break;
             default:
                 THROW_ERROR("Invalid type " << expr.type << " encountered");
             }
-            linearModel.mapping().emplace(i, newId);
+            linearModel.setMapping(i, newId);
         }
     }
 }
 
+ExpressionId ToLinear::Transformer::createQuadratic(uint32_t i) {
+    const auto &expr = model.expression(i);
+    double factor = 1.0;
+    vector<ExpressionId> operands;
+    for (ExpressionId op : expr.operands) {
+        if (!model.isConstant(op.var()))
+            operands.push_back(getExpressionId(op));
+        else if (expr.op == UMO_OP_PROD)
+            factor *= model.getExpressionIdValue(op);
+    }
+    // Square
+    if (operands.size() == 1)
+        operands.push_back(operands[0]);
+    if (factor != 1.0)
+        operands.push_back(linearModel.createConstant(factor));
+    return linearModel.createExpression(UMO_OP_PROD, operands);
+}
+
+ExpressionId ToLinear::Transformer::createAuxiliary(uint32_t i,
+                                                   umo_operator op) {
+    if (bounds.empty() || bounds[i].empty()) {
+        return linearModel.createExpression(op, {constantMInf, constantPInf});
+    }
+    double lb = bounds[i].lb;
+    double ub = bounds[i].ub;
+    if (op == UMO_OP_DEC_FLOAT) {
+        // Relax continuous bounds slightly to avoid numerical issues
+        lb -= auxiliaryBoundMargin * max(1.0, abs(lb));
+        ub += auxiliaryBoundMargin * max(1.0, abs(ub));
+    }
+    ExpressionId lbId = linearModel.createConstant(lb);
+    ExpressionId ubId = linearModel.createConstant(ub);
+    return linearModel.createExpression(op, {lbId, ubId});
+}
+
 void ToLinear::Transformer::linearizeExpressions() {
-    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+    for (uint32_t i = first; i < model.nbExpressions(); ++i) {
         linearize(i);
     }
 }
 
+void ToLinear::Transformer::linearizeNewConstraints() {
+    for (uint32_t i : newConstraints) {
+        double val = model.isConstraintPos(i) ? 1.0 : 0.0;
+        makeConstraint({1.0}, {ExpressionId::fromVar(i)}, val, val);
+    }
+}
+
 void ToLinear::Transformer::createObjectives() {
     for (const auto obj : model.objectives()) {
-        Element elt = getElement(obj.first);
-        bool maxObj = (obj.second == UMO_OBJ_MAXIMIZE) ^ (elt.coef < 0.0);
-        umo_objective_direction dir =
-            maxObj ? UMO_OBJ_MAXIMIZE : UMO_OBJ_MINIMIZE;
-        linearModel.createObjective(ExpressionId(elt.var, false, false), dir);
+        // Linear form of the objective, written directly by the solvers
+        vector<double> coefs;
+        vector<Element> elements;
+        addTerms(obj.first, 1.0, coefs, elements);
+        vector<ExpressionId> operands;
+        double offset = addOperands(coefs, elements, operands);
+        if (offset != 0.0) {
+            operands.push_back(linearModel.createConstant(offset));
+            operands.push_back(constantPOne);
+        }
+        ExpressionId linear =
+            linearModel.createExpression(UMO_OP_LINEAR, operands);
+        linearModel.createObjective(linear, obj.second);
     }
 }
 
 void ToLinear::Transformer::linearize(uint32_t i) {
-    if (model.isLeaf(i))
+    if (model.isLeaf(i) || isInlined(i) || isQuadratic(i))
         return;
     umo_operator op = model.expression(i).op;
     switch (op) {
@@ -181,20 +762,59 @@ void ToLinear::Transformer::linearize(uint32_t i) {
     case UMO_OP_XOR:
         linearizeXor(i);
         break;
+    case UMO_OP_MIN:
+    case UMO_OP_MAX:
+        linearizeMinMax(i);
+        break;
+    case UMO_OP_ABS:
+        linearizeAbs(i);
+        break;
+    case UMO_OP_IDIV:
+    case UMO_OP_MOD:
+        linearizeDivMod(i);
+        break;
+    case UMO_OP_ROUND:
+    case UMO_OP_FLOOR:
+    case UMO_OP_CEIL:
+        linearizeRounding(i);
+        break;
+    case UMO_OP_SIGN:
+        linearizeSign(i);
+        break;
     case UMO_OP_LINEARCOMP:
         // Copy the expression as is
         copyExpression(i);
         break;
     default:
+        if (piecewise && isPiecewiseLinearizable(model, i)) {
+            linearizePiecewise(i);
+            break;
+        }
         THROW_ERROR("Operand type " << op << " not handled for linearization");
     }
 }
 
 void ToLinear::Transformer::run() {
-    createExpressions();
-    createObjectives();
+    computeDirections(model, preferLarger, preferSmaller);
+    relaxed.resize(model.nbExpressions());
+    if (restore()) {
+        // Previous bounds remain valid as constraints were only added
+        if (!bounds.empty())
+            BoundTightening().extend(model, bounds);
+        findInlined();
+        createExpressions();
+        linearizeNewConstraints();
+    } else {
+        if (!BoundTightening().propagate(model, bounds)) {
+            model.setInfeasible();
+            return;
+        }
+        findInlined();
+        createExpressions();
+        createObjectives();
+    }
     linearizeExpressions();
-    model.apply(linearModel);
+    save();
 }
 
 ToLinear::Element ToLinear::Transformer::getElement(ExpressionId id, bool useOriginalId) const {
@@ -208,7 +828,7 @@ ToLinear::Element ToLinear::Transformer::getElement(ExpressionId id, bool useOri
             return elt;
         }
         else {
-            pid = linearModel.mapping().at(id.var());
+            pid = linearModel.getMapping(id.var());
         }
     }
     else {
@@ -231,11 +851,50 @@ ToLinear::Element ToLinear::Transformer::getElement(ExpressionId id, bool useOri
     return elt;
 }
 
+void ToLinear::Transformer::addTerms(ExpressionId id, double coef,
+                                     vector<double> &coefs,
+                                     vector<Element> &elements) const {
+    if (!isInlined(id.var())) {
+        coefs.push_back(coef);
+        elements.push_back(getElement(id));
+        return;
+    }
+    if (id.isMinus())
+        coef = -coef;
+    const auto &expr = model.expression(id.var());
+    if (expr.op == UMO_OP_SUM) {
+        for (ExpressionId op : expr.operands) {
+            addTerms(op, coef, coefs, elements);
+        }
+        return;
+    }
+    // Product with at most one variable operand
+    double factor = 1.0;
+    ExpressionId variable;
+    for (ExpressionId op : expr.operands) {
+        if (model.isConstant(op.var()))
+            factor *= model.getExpressionIdValue(op);
+        else
+            variable = op;
+    }
+    if (variable.valid()) {
+        addTerms(variable, coef * factor, coefs, elements);
+    } else {
+        // Constant term
+        Element elt;
+        elt.var = constantZero.var();
+        elt.coef = 0.0;
+        elt.constant = 1.0;
+        coefs.push_back(coef * factor);
+        elements.push_back(elt);
+    }
+}
+
 ExpressionId ToLinear::Transformer::getExpressionId(ExpressionId id) {
     if (model.isConstant(id.var())) {
         return linearModel.createConstant(model.getExpressionIdValue(id));
     }
-    ExpressionId pid = linearModel.mapping().at(id.var());
+    ExpressionId pid = linearModel.getMapping(id.var());
     assert (!id.isNot() || !pid.isMinus() /*Inconsistent types (applying not to a general integer)*/);
     if (id.isNot())
         pid = pid.getNot();
@@ -244,7 +903,45 @@ ExpressionId ToLinear::Transformer::getExpressionId(ExpressionId id) {
     return pid;
 }
 
-void ToLinear::Transformer::makeConstraint(const vector<double> &coefs,
+double ToLinear::Transformer::addOperands(const vector<double> &coefs,
+                                         const vector<Element> &ops,
+                                         vector<ExpressionId> &operands) {
+    double offset = 0.0;
+    // Gather all operands; handle constants and compressed operands
+    // efficiently, and merge the terms on the same variable
+    vector<uint32_t> vars;
+    vector<double> varCoefs;
+    unordered_map<uint32_t, size_t> positions;
+    for (uint32_t i = 0; i < coefs.size(); ++i) {
+        double coef = coefs[i];
+        Element elt = ops[i];
+        if (linearModel.isConstant(elt.var)) {
+            // Constant in the linear model (happens for example when
+            // replacing a constraint)
+            offset += coef * (elt.constant +
+                              elt.coef * linearModel.value(elt.var));
+            continue;
+        }
+        auto it = positions.find(elt.var);
+        if (it == positions.end()) {
+            positions.emplace(elt.var, vars.size());
+            vars.push_back(elt.var);
+            varCoefs.push_back(coef * elt.coef);
+        } else {
+            varCoefs[it->second] += coef * elt.coef;
+        }
+        offset += coef * elt.constant;
+    }
+    for (size_t i = 0; i < vars.size(); ++i) {
+        if (varCoefs[i] == 0.0)
+            continue;
+        operands.push_back(linearModel.createConstant(varCoefs[i]));
+        operands.push_back(ExpressionId(vars[i], false, false));
+    }
+    return offset;
+}
+
+ExpressionId ToLinear::Transformer::makeRow(const vector<double> &coefs,
                                            const vector<Element> &ops,
                                            double lb, double ub) {
     if (lb > ub) {
@@ -259,54 +956,44 @@ void ToLinear::Transformer::makeConstraint(const vector<double> &coefs,
     operands.emplace_back();
     operands.emplace_back();
     // Overall offset for the constraint's bounds
-    double offset = 0.0;
-    // Gather all operands; handle constants and compressed operands efficiently
-    for (uint32_t i = 0; i < coefs.size(); ++i) {
-        double coef = coefs[i];
-        Element elt = ops[i];
-        if (linearModel.isConstant(elt.var)) {
-            // Constant in the linear model (happens for example when
-            // replacing a constraint)
-            offset += coef * (elt.constant +
-                              elt.coef * linearModel.value(elt.var));
-        } else {
-            operands.push_back(linearModel.createConstant(coef * elt.coef));
-            operands.push_back(ExpressionId(elt.var, false, false));
-            offset += coef * elt.constant;
-        }
-    }
+    double offset = addOperands(coefs, ops, operands);
     // Lower/upper bound of the constraint
     lb -= offset;
     ub -= offset;
     if (operands.size() == 2) {
         // TODO: add some margin here
-        if (lb > 0.0 || ub < 0.0) {
-            // Obviously invalid
-            THROW_ERROR("Constraint is obviously infeasible");
-        } else {
-            // Obviously valid
-            return;
-        }
+        return lb > 0.0 || ub < 0.0 ? constantZero : constantPOne;
     }
-    ExpressionId lbId = linearModel.createConstant(lb);
-    ExpressionId ubId = linearModel.createConstant(ub);
-    operands[0] = lbId;
-    operands[1] = ubId;
-    // Constraint creation
-    ExpressionId linearized =
-        linearModel.createExpression(UMO_OP_LINEARCOMP, operands);
-    linearModel.createConstraint(linearized);
+    operands[0] = linearModel.createConstant(lb);
+    operands[1] = linearModel.createConstant(ub);
+    return linearModel.createExpression(UMO_OP_LINEARCOMP, operands);
+}
+
+void ToLinear::Transformer::makeConstraint(const vector<double> &coefs,
+                                           const vector<Element> &ops,
+                                           double lb, double ub) {
+    ExpressionId row = makeRow(coefs, ops, lb, ub);
+    if (row == constantZero)
+        THROW_ERROR("Constraint is obviously infeasible");
+    // Nothing to do if the constraint is obviously valid
+    if (row != constantPOne)
+        linearModel.createConstraint(row);
 }
 
 void ToLinear::Transformer::makeConstraint(const vector<double> &coefs,
                                            const vector<ExpressionId> &ops,
                                            double lb, double ub, bool useOriginalId) {
+    vector<double> termCoefs;
     vector<Element> elements;
-    elements.reserve(ops.size());
-    for (ExpressionId op : ops) {
-        elements.push_back(getElement(op, useOriginalId));
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (useOriginalId) {
+            addTerms(ops[i], coefs[i], termCoefs, elements);
+        } else {
+            termCoefs.push_back(coefs[i]);
+            elements.push_back(getElement(ops[i], false));
+        }
     }
-    makeConstraint(coefs, elements, lb, ub);
+    makeConstraint(termCoefs, elements, lb, ub);
 }
 
 void ToLinear::Transformer::constrainToSum(uint32_t i,
@@ -362,26 +1049,194 @@ void ToLinear::Transformer::linearizeProd(uint32_t i) {
     assert(expr.op == UMO_OP_PROD);
     double constantProd = 1.0;
     ExpressionId variableProd;
+    vector<ExpressionId> booleans;
     for (ExpressionId id : expr.operands) {
         if (model.isConstant(id.var())) {
             constantProd *= model.getExpressionIdValue(id);
+        } else if (model.expression(id.var()).type == UMO_TYPE_BOOL) {
+            if (id.isMinus())
+                constantProd = -constantProd;
+            booleans.push_back(ExpressionId(id.var(), id.isNot(), false));
         } else if (!variableProd.valid()) {
             variableProd = id;
         } else {
-            THROW_ERROR(
-                "Impossible to linearize product with multiple variables");
+            THROW_ERROR("Impossible to linearize product with multiple "
+                        "non-boolean variables");
         }
     }
+    if (booleans.empty()) {
+        if (variableProd.valid()) {
+            constrainToProd(i, variableProd, constantProd);
+        } else {
+            constrainToSum(i, {}, -constantProd, -constantProd);
+        }
+        return;
+    }
+    if (constantProd == 0.0) {
+        constrainToSum(i, {}, 0.0, 0.0);
+        return;
+    }
+    // The product of the variables is the expression divided by the constant
+    Element prod = getElement(ExpressionId::fromVar(i));
+    prod.coef /= constantProd;
+    Element conj = booleans.size() == 1 ? getElement(booleans[0])
+                                        : makeAnd(booleans);
     if (variableProd.valid()) {
-        constrainToProd(i, variableProd, constantProd);
+        constrainBoolProd(prod, conj, variableProd);
     } else {
-        constrainToSum(i, {}, -constantProd, -constantProd);
+        makeConstraint({1.0, -1.0}, {prod, conj}, 0.0, 0.0);
+    }
+}
+
+ToLinear::Element
+ToLinear::Transformer::makeAnd(const vector<ExpressionId> &operands) {
+    ExpressionId conjId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+    Element conj = getElement(conjId, false);
+    vector<double> coefs;
+    vector<Element> elements;
+    for (ExpressionId op : operands) {
+        Element elt = getElement(op);
+        // conj ==> op
+        makeConstraint({1.0, -1.0}, {conj, elt},
+                       -numeric_limits<double>::infinity(), 0.0);
+        coefs.push_back(1.0);
+        elements.push_back(elt);
     }
+    // All operands ==> conj
+    coefs.push_back(-1.0);
+    elements.push_back(conj);
+    makeConstraint(coefs, elements, -numeric_limits<double>::infinity(),
+                   operands.size() - 1.0);
+    return conj;
+}
+
+void ToLinear::Transformer::constrainBoolProd(Element prod, Element cond,
+                                              ExpressionId op) {
+    Interval b = getBounds(op);
+    if (!b.isFinite())
+        THROW_ERROR("Impossible to linearize the product of a boolean with an "
+                    "unbounded expression");
+    Element var = getElement(op);
+    const double inf = numeric_limits<double>::infinity();
+    // lb * cond <= prod <= ub * cond
+    makeConstraint({1.0, -b.lb}, {prod, cond}, 0.0, inf);
+    makeConstraint({1.0, -b.ub}, {prod, cond}, -inf, 0.0);
+    // op - ub * (1 - cond) <= prod <= op - lb * (1 - cond)
+    makeConstraint({1.0, -1.0, -b.ub}, {prod, var, cond}, -b.ub, inf);
+    makeConstraint({1.0, -1.0, -b.lb}, {prod, var, cond}, -inf, -b.lb);
+}
+
+void ToLinear::Transformer::makeImplication(Element cond,
+                                            const vector<double> &coefs,
+                                            const vector<ExpressionId> &ops,
+                                            double lb, double ub) {
+    if (linearModel.isConstant(cond.var)) {
+        double val = cond.constant + cond.coef * linearModel.value(cond.var);
+        if (val > 0.5)
+            makeConstraint(coefs, ops, lb, ub);
+        return;
+    }
+    vector<double> termCoefs;
+    vector<Element> elements;
+    Interval activity(0.0);
+    for (size_t j = 0; j < ops.size(); ++j) {
+        addTerms(ops[j], coefs[j], termCoefs, elements);
+        activity = activity + Interval(coefs[j]) * getBounds(ops[j]);
+    }
+    if (indicators) {
+        ExpressionId row = makeRow(termCoefs, elements, lb, ub);
+        if (row == constantZero) {
+            // The condition cannot be true
+            makeConstraint({1.0}, {cond}, 0.0, 0.0);
+        } else if (row != constantPOne) {
+            // Written as cond ==> row by the solvers
+            ExpressionId lit(cond.var, cond.coef < 0.0, false);
+            linearModel.createConstraint(
+                linearModel.createExpression(UMO_OP_OR, {lit.getNot(), row}));
+        }
+        return;
+    }
+    const double inf = numeric_limits<double>::infinity();
+    if (activity.ub > ub) {
+        // sum <= ub + M * (1 - cond)
+        double bigM = activity.ub - ub;
+        if (!isfinite(bigM))
+            THROW_ERROR("Impossible to linearize a comparison of unbounded "
+                        "expressions");
+        termCoefs.push_back(bigM);
+        elements.push_back(cond);
+        makeConstraint(termCoefs, elements, -inf, ub + bigM);
+        termCoefs.pop_back();
+        elements.pop_back();
+    }
+    if (activity.lb < lb) {
+        // sum >= lb - M * (1 - cond)
+        double bigM = lb - activity.lb;
+        if (!isfinite(bigM))
+            THROW_ERROR("Impossible to linearize a comparison of unbounded "
+                        "expressions");
+        termCoefs.push_back(-bigM);
+        elements.push_back(cond);
+        makeConstraint(termCoefs, elements, lb - bigM, inf);
+    }
+}
+
+void ToLinear::Transformer::constrainNotEqual(Element eq, ExpressionId op1,
+                                              ExpressionId op2) {
+    const double inf = numeric_limits<double>::infinity();
+    double margin = strictMargin(op1, op2);
+    ExpressionId belowId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId aboveId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+    Element below = getElement(belowId, false);
+    Element above = getElement(aboveId, false);
+    // Exactly one of eq, op1 < op2 and op1 > op2 is selected
+    makeConstraint({1.0, 1.0, 1.0}, {eq, below, above}, 1.0, 1.0);
+    makeImplication(below, {1.0, -1.0}, {op1, op2}, -inf, -margin);
+    makeImplication(above, {1.0, -1.0}, {op1, op2}, margin, inf);
+}
+
+ToLinear::Element ToLinear::Transformer::makeSign(ExpressionId op) {
+    Interval b = getBounds(op);
+    if (b.lb >= 0.0)
+        return {constantZero.var(), 0.0, 1.0};
+    if (b.ub < 0.0)
+        return {constantZero.var(), 0.0, 0.0};
+    const double inf = numeric_limits<double>::infinity();
+    ExpressionId signId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+    Element sign = getElement(signId, false);
+    Element notSign = getElement(signId.getNot(), false);
+    makeImplication(sign, {1.0}, {op}, 0.0, inf);
+    makeImplication(notSign, {1.0}, {op}, -inf, -strictMargin(op, op));
+    return sign;
+}
+
+double ToLinear::Transformer::strictMargin(ExpressionId op1,
+                                           ExpressionId op2) const {
+    // Integer expressions differ by at least one
+    if (model.expression(op1.var()).type != UMO_TYPE_FLOAT &&
+        model.expression(op2.var()).type != UMO_TYPE_FLOAT)
+        return 1.0;
+    return strictEqualityMargin;
+}
+
+Interval ToLinear::Transformer::getBounds(ExpressionId id) const {
+    if (model.isConstant(id.var()))
+        return Interval(model.getExpressionIdValue(id));
+    if (bounds.empty())
+        return Interval::full();
+    Interval ret = bounds[id.var()];
+    if (id.isNot())
+        ret = Interval(1.0 - ret.ub, 1.0 - ret.lb);
+    if (id.isMinus())
+        ret = -ret;
+    return ret;
 }
 
 void ToLinear::Transformer::linearizeCompare(uint32_t i) {
-    if (!model.isConstraint(i))
-        THROW_ERROR("Comparisons that are not constraints are not handled yet");
+    if (!model.isConstraint(i)) {
+        linearizeReifiedCompare(i);
+        return;
+    }
     if (model.isConstraintPos(i) && model.isConstraintNeg(i))
         THROW_ERROR("The variable is constrained both ways. Model is "
                     "obviously inconsistent");
@@ -396,7 +1251,7 @@ void ToLinear::Transformer::linearizeCompare(uint32_t i) {
             linearizeConstrainedEq(op1, op2);
             break;
         case UMO_OP_CMP_NEQ:
-            THROW_ERROR("Impossible to constrain not equal");
+            linearizeConstrainedNeq(op1, op2);
             break;
         case UMO_OP_CMP_LEQ:
             linearizeConstrainedLeq(op1, op2);
@@ -417,7 +1272,7 @@ void ToLinear::Transformer::linearizeCompare(uint32_t i) {
     } else {
         switch (expr.op) {
         case UMO_OP_CMP_EQ:
-            THROW_ERROR("Impossible to constrain not equal");
+            linearizeConstrainedNeq(op1, op2);
             break;
         case UMO_OP_CMP_NEQ:
             linearizeConstrainedEq(op1, op2);
@@ -441,6 +1296,59 @@ void ToLinear::Transformer::linearizeCompare(uint32_t i) {
     }
 }
 
+void ToLinear::Transformer::linearizeReifiedCompare(uint32_t i) {
+    const auto &expr = model.expression(i);
+    const double inf = numeric_limits<double>::infinity();
+    ExpressionId op1 = expr.operands[0];
+    ExpressionId op2 = expr.operands[1];
+    umo_operator op = expr.op;
+    if (op == UMO_OP_CMP_GEQ || op == UMO_OP_CMP_GT) {
+        swap(op1, op2);
+        op = op == UMO_OP_CMP_GEQ ? UMO_OP_CMP_LEQ : UMO_OP_CMP_LT;
+    }
+    Element res = getElement(ExpressionId::fromVar(i));
+    Element notRes = getElement(ExpressionId::fromVar(i).getNot());
+    // res ==> comparison is only needed if a true value may help, and
+    // !res ==> !comparison if a false value may help
+    bool implies = preferLarger[i];
+    bool implied = preferSmaller[i];
+    relaxed[i] = (implies ? 0 : relaxedAbove) | (implied ? 0 : relaxedBelow);
+    switch (op) {
+    case UMO_OP_CMP_LEQ:
+    case UMO_OP_CMP_LT: {
+        double margin = strictMargin(op1, op2);
+        double trueUb = op == UMO_OP_CMP_LEQ ? 0.0 : -margin;
+        double falseLb = op == UMO_OP_CMP_LEQ ? margin : 0.0;
+        if (implies)
+            makeImplication(res, {1.0, -1.0}, {op1, op2}, -inf, trueUb);
+        if (implied)
+            makeImplication(notRes, {1.0, -1.0}, {op1, op2}, falseLb, inf);
+        break;
+    }
+    case UMO_OP_CMP_EQ:
+        if (implies)
+            makeImplication(res, {1.0, -1.0}, {op1, op2}, 0.0, 0.0);
+        if (implied)
+            constrainNotEqual(res, op1, op2);
+        break;
+    case UMO_OP_CMP_NEQ:
+        if (implied)
+            makeImplication(notRes, {1.0, -1.0}, {op1, op2}, 0.0, 0.0);
+        if (implies)
+            constrainNotEqual(notRes, op1, op2);
+        break;
+    default:
+        THROW_ERROR("Operator is not handled");
+    }
+}
+
+void ToLinear::Transformer::linearizeConstrainedNeq(ExpressionId op1,
+                                                    ExpressionId op2) {
+    // The equality is never selected
+    Element never = {constantZero.var(), 1.0, 0.0};
+    constrainNotEqual(never, op1, op2);
+}
+
 void ToLinear::Transformer::linearizeAnd(uint32_t i) {
     const auto &expr = model.expression(i);
     assert(expr.op == UMO_OP_AND);
@@ -468,6 +1376,27 @@ void ToLinear::Transformer::linearizeXor(uint32_t i) {
     const auto &expr = model.expression(i);
     assert(expr.op == UMO_OP_XOR);
     vector<ExpressionId> operands = expr.operands;
+    bool parity = xorEncoding == "parity" ||
+                  (xorEncoding == "auto" &&
+                   operands.size() > maxChainedXorArity);
+    if (parity) {
+        // sum xi - y = 2 * k for an integer k
+        double maxK = floor(operands.size() / 2.0);
+        ExpressionId k = linearModel.createExpression(
+            UMO_OP_DEC_INT, {constantZero, linearModel.createConstant(maxK)});
+        vector<double> coefs(operands.size(), 1.0);
+        vector<Element> elements;
+        for (ExpressionId op : operands) {
+            elements.push_back(getElement(op));
+        }
+        coefs.push_back(-1.0);
+        elements.push_back(getElement(ExpressionId::fromVar(i)));
+        coefs.push_back(-2.0);
+        elements.push_back(getElement(k, false));
+        makeConstraint(coefs, elements, 0.0, 0.0);
+        return;
+    }
+    // Chain of two-way XORs starting from !y, whose last element is true
     ExpressionId id = ExpressionId::fromVar(i).getNot();
     Element elt = getElement(id, true);
     for (ExpressionId op : operands) {
@@ -483,6 +1412,207 @@ void ToLinear::Transformer::linearizeXor(uint32_t i) {
     makeConstraint({1.0}, {elt}, 1.0, numeric_limits<double>::infinity());
 }
 
+void ToLinear::Transformer::linearizeMinMax(uint32_t i) {
+    const auto &expr = model.expression(i);
+    bool isMax = expr.op == UMO_OP_MAX;
+    const double inf = numeric_limits<double>::infinity();
+    Element res = getElement(ExpressionId::fromVar(i));
+    // res >= op for a max, res <= op for a min
+    for (ExpressionId op : expr.operands) {
+        makeConstraint({1.0, -1.0}, {res, getElement(op)}, isMax ? 0.0 : -inf,
+                       isMax ? inf : 0.0);
+    }
+    if (isRelaxable(expr.op, preferLarger[i], preferSmaller[i])) {
+        // The other side is enforced by the objective or the constraints
+        relaxed[i] = isMax ? relaxedAbove : relaxedBelow;
+        return;
+    }
+    // One binary per operand selects the operand equal to the result
+    Interval resBounds = getBounds(expr.operands[0]);
+    for (ExpressionId op : expr.operands) {
+        Interval b = getBounds(op);
+        double lb = isMax ? max(resBounds.lb, b.lb) : min(resBounds.lb, b.lb);
+        double ub = isMax ? max(resBounds.ub, b.ub) : min(resBounds.ub, b.ub);
+        resBounds = Interval(lb, ub);
+    }
+    vector<double> coefs;
+    vector<Element> selectors;
+    for (ExpressionId op : expr.operands) {
+        Interval b = getBounds(op);
+        double bigM = isMax ? resBounds.ub - b.lb : b.ub - resBounds.lb;
+        if (!isfinite(bigM))
+            THROW_ERROR("Impossible to linearize "
+                        << (isMax ? "max" : "min")
+                        << " of unbounded expressions");
+        ExpressionId selId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+        Element sel = getElement(selId, false);
+        if (isMax) {
+            // res <= op + M * (1 - sel)
+            makeConstraint({1.0, -1.0, bigM}, {res, getElement(op), sel}, -inf,
+                           bigM);
+        } else {
+            // res >= op - M * (1 - sel)
+            makeConstraint({1.0, -1.0, -bigM}, {res, getElement(op), sel},
+                           -bigM, inf);
+        }
+        coefs.push_back(1.0);
+        selectors.push_back(sel);
+    }
+    makeConstraint(coefs, selectors, 1.0, 1.0);
+}
+
+void ToLinear::Transformer::linearizeAbs(uint32_t i) {
+    const auto &expr = model.expression(i);
+    assert(expr.op == UMO_OP_ABS);
+    const double inf = numeric_limits<double>::infinity();
+    Element res = getElement(ExpressionId::fromVar(i));
+    Element op = getElement(expr.operands[0]);
+    Interval b = getBounds(expr.operands[0]);
+    // Known sign
+    if (b.lb >= 0.0) {
+        makeConstraint({1.0, -1.0}, {res, op}, 0.0, 0.0);
+        return;
+    }
+    if (b.ub <= 0.0) {
+        makeConstraint({1.0, 1.0}, {res, op}, 0.0, 0.0);
+        return;
+    }
+    // res >= op and res >= -op
+    makeConstraint({1.0, -1.0}, {res, op}, 0.0, inf);
+    makeConstraint({1.0, 1.0}, {res, op}, 0.0, inf);
+    if (isRelaxable(expr.op, preferLarger[i], preferSmaller[i])) {
+        relaxed[i] = relaxedAbove;
+        return;
+    }
+    if (!b.isFinite())
+        THROW_ERROR("Impossible to linearize abs of an unbounded expression");
+    // The binary is true if the operand is positive
+    double resUb = max(-b.lb, b.ub);
+    double bigMPos = resUb - b.lb;
+    double bigMNeg = resUb + b.ub;
+    ExpressionId posId = linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+    Element pos = getElement(posId, false);
+    // res <= op + M * (1 - pos)
+    makeConstraint({1.0, -1.0, bigMPos}, {res, op, pos}, -inf, bigMPos);
+    // res <= -op + M * pos
+    makeConstraint({1.0, 1.0, -bigMNeg}, {res, op, pos}, -inf, 0.0);
+}
+
+void ToLinear::Transformer::linearizeDivMod(uint32_t i) {
+    const auto &expr = model.expression(i);
+    ExpressionId n = expr.operands[0];
+    if (!model.isConstant(expr.operands[1].var()))
+        THROW_ERROR("Impossible to linearize a division by a variable");
+    double d = model.getExpressionIdValue(expr.operands[1]);
+    if (d == 0.0)
+        THROW_ERROR("Division by zero during linearization");
+    // n = d * q + r, with the remainder r of the sign of n and |r| < |d|
+    vector<double> remCoefs;
+    vector<ExpressionId> remOps;
+    if (expr.op == UMO_OP_IDIV) {
+        remCoefs = {1.0, -d};
+        remOps = {n, ExpressionId::fromVar(i)};
+    } else {
+        Interval qb = getBounds(n) / Interval(d);
+        ExpressionId q = linearModel.createExpression(
+            UMO_OP_DEC_INT, {linearModel.createConstant(trunc(qb.lb)),
+                             linearModel.createConstant(trunc(qb.ub))});
+        makeConstraint({1.0, -d, -1.0},
+                       {getElement(n), getElement(q, false),
+                        getElement(ExpressionId::fromVar(i))},
+                       0.0, 0.0);
+        remCoefs = {1.0};
+        remOps = {ExpressionId::fromVar(i)};
+    }
+    double maxRem = abs(d) - 1.0;
+    Element sign = makeSign(n);
+    Element notSign = {sign.var, -sign.coef, 1.0 - sign.constant};
+    makeImplication(sign, remCoefs, remOps, 0.0, maxRem);
+    makeImplication(notSign, remCoefs, remOps, -maxRem, 0.0);
+}
+
+void ToLinear::Transformer::linearizeRounding(uint32_t i) {
+    const auto &expr = model.expression(i);
+    ExpressionId op = expr.operands[0];
+    ExpressionId res = ExpressionId::fromVar(i);
+    double margin = strictEqualityMargin;
+    switch (expr.op) {
+    case UMO_OP_FLOOR:
+        // res <= op < res + 1
+        makeConstraint({1.0, -1.0}, {op, res}, 0.0, 1.0 - margin);
+        break;
+    case UMO_OP_CEIL:
+        // res - 1 < op <= res
+        makeConstraint({1.0, -1.0}, {res, op}, 0.0, 1.0 - margin);
+        break;
+    case UMO_OP_ROUND: {
+        // Halfway cases are rounded away from zero
+        Element sign = makeSign(op);
+        Element notSign = {sign.var, -sign.coef, 1.0 - sign.constant};
+        makeImplication(sign, {1.0, -1.0}, {res, op}, -0.5 + margin, 0.5);
+        makeImplication(notSign, {1.0, -1.0}, {res, op}, -0.5, 0.5 - margin);
+        break;
+    }
+    default:
+        THROW_ERROR("Operator is not handled");
+    }
+}
+
+void ToLinear::Transformer::linearizeSign(uint32_t i) {
+    const auto &expr = model.expression(i);
+    assert(expr.op == UMO_OP_SIGN);
+    // res = 2 * (op >= 0) - 1
+    Element sign = makeSign(expr.operands[0]);
+    makeConstraint({1.0, -2.0}, {getElement(ExpressionId::fromVar(i)), sign},
+                   -1.0, -1.0);
+}
+
+void ToLinear::Transformer::linearizePiecewise(uint32_t i) {
+    const auto &expr = model.expression(i);
+    ExpressionId op;
+    for (ExpressionId id : expr.operands) {
+        if (!model.isConstant(id.var()))
+            op = id;
+    }
+    bool integer = model.expression(op.var()).type != UMO_TYPE_FLOAT;
+    vector<double> points;
+    vector<double> values;
+    if (!computeBreakpoints(model, i, getBounds(op), integer,
+                            piecewiseTolerance, points, values))
+        THROW_ERROR("Impossible to approximate operator "
+                    << expr.op << " by a piecewise linear function");
+    // Incremental formulation: the fill ratio of each segment, and binaries
+    // that only allow a segment to be used once the previous one is full
+    //     op = t0 + sum dj * (tj+1 - tj)
+    //     res = f0 + sum dj * (fj+1 - fj)
+    //     dj+1 <= zj <= dj
+    vector<double> opCoefs = {1.0};
+    vector<Element> opElements = {getElement(op)};
+    vector<double> resCoefs = {1.0};
+    vector<Element> resElements = {getElement(ExpressionId::fromVar(i))};
+    Element prevFill;
+    for (size_t j = 0; j + 1 < points.size(); ++j) {
+        ExpressionId fillId = linearModel.createExpression(
+            UMO_OP_DEC_FLOAT, {constantZero, constantPOne});
+        Element fill = getElement(fillId, false);
+        opCoefs.push_back(points[j] - points[j + 1]);
+        opElements.push_back(fill);
+        resCoefs.push_back(values[j] - values[j + 1]);
+        resElements.push_back(fill);
+        if (j > 0) {
+            ExpressionId orderId =
+                linearModel.createExpression(UMO_OP_DEC_BOOL, {});
+            Element order = getElement(orderId, false);
+            const double inf = numeric_limits<double>::infinity();
+            makeConstraint({1.0, -1.0}, {order, fill}, 0.0, inf);
+            makeConstraint({1.0, -1.0}, {order, prevFill}, -inf, 0.0);
+        }
+        prevFill = fill;
+    }
+    makeConstraint(opCoefs, opElements, points[0], points[0]);
+    makeConstraint(resCoefs, resElements, values[0], values[0]);
+}
+
 void ToLinear::Transformer::copyExpression(uint32_t i) {
     const auto &expr = model.expression(i);
     vector<ExpressionId> operands;
@@ -497,21 +1627,15 @@ void ToLinear::Transformer::copyExpression(uint32_t i) {
         linearModel.createConstraint(linearized.getNot());
 }
 
-namespace {
-int countNonConstantOperands(const PresolvedModel &model, const Model::ExpressionData &expr) {
-    int nbNonConstant = 0;
-    for (ExpressionId id : expr.operands) {
-        if (!model.isConstant(id.var())) {
-            ++nbNonConstant;
-        }
-    }
-    return nbNonConstant;
-}
-}
-
-bool ToLinear::valid(const PresolvedModel &model) const {
+bool ToLinear::valid(const PresolvedModel &model, bool linearOnly) const {
     if (model.nbObjectives() > 1)
         return false;
+    bool indicators = !linearOnly && useIndicators(model);
+    bool quadratic = !linearOnly && useQuadratic(model);
+    // Bounds and directions of the expressions, computed on demand
+    vector<Interval> bounds;
+    vector<char> preferLarger;
+    vector<char> preferSmaller;
     for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
         const auto &expr = model.expression(i);
         switch (expr.op) {
@@ -522,33 +1646,135 @@ bool ToLinear::valid(const PresolvedModel &model) const {
         case UMO_OP_DEC_FLOAT:
         case UMO_OP_AND:
         case UMO_OP_OR:
+        case UMO_OP_XOR:
         case UMO_OP_SUM:
             continue;
-        case UMO_OP_PROD:
-            if (countNonConstantOperands(model, expr) >= 2) {
+        case UMO_OP_PROD: {
+            if (quadratic && isQuadraticTerm(model, i))
+                continue;
+            // Booleans and at most one other variable, that must be bounded
+            // if there are booleans
+            ExpressionId variable;
+            int nbBooleans = 0;
+            for (ExpressionId id : expr.operands) {
+                if (model.isConstant(id.var()))
+                    continue;
+                if (model.expression(id.var()).type == UMO_TYPE_BOOL)
+                    ++nbBooleans;
+                else if (variable.valid())
+                    return false;
+                else
+                    variable = id;
+            }
+            if (nbBooleans == 0 || !variable.valid())
+                continue;
+            if (bounds.empty() && !BoundTightening().propagate(model, bounds))
+                return false;
+            if (!bounds[variable.var()].isFinite())
+                return false;
+            continue;
+        }
+        case UMO_OP_MIN:
+        case UMO_OP_MAX:
+        case UMO_OP_ABS: {
+            if (preferLarger.empty())
+                computeDirections(model, preferLarger, preferSmaller);
+            if (isRelaxable(expr.op, preferLarger[i], preferSmaller[i]))
+                continue;
+            // Big-M formulations need the bounds of the operands
+            if (bounds.empty() && !BoundTightening().propagate(model, bounds))
                 return false;
+            for (ExpressionId op : expr.operands) {
+                const Interval &b = bounds[op.var()];
+                bool knownSign = b.lb >= 0.0 || b.ub <= 0.0;
+                if (!b.isFinite() && !(expr.op == UMO_OP_ABS && knownSign))
+                    return false;
             }
             continue;
+        }
         case UMO_OP_CMP_EQ:
         case UMO_OP_CMP_NEQ:
         case UMO_OP_CMP_LEQ:
         case UMO_OP_CMP_GEQ:
         case UMO_OP_CMP_LT:
-        case UMO_OP_CMP_GT:
-            if (!model.isConstraint(i)) {
+        case UMO_OP_CMP_GT: {
+            if (model.isConstraintPos(i) && model.isConstraintNeg(i)) {
                 return false;
             }
-            if (model.isConstraintPos(i) && model.isConstraintNeg(i)) {
+            bool notEqual = model.isConstraintPos(i)
+                                ? expr.op == UMO_OP_CMP_NEQ
+                                : expr.op == UMO_OP_CMP_EQ;
+            if (model.isConstraint(i) && !notEqual)
+                continue;
+            // Indicator constraints need no bounds
+            if (indicators)
+                continue;
+            if (preferLarger.empty())
+                computeDirections(model, preferLarger, preferSmaller);
+            if (!model.isConstraint(i) && !preferLarger[i] && !preferSmaller[i])
+                continue;
+            // Big-M formulations need the bounds of the operands
+            if (bounds.empty() && !BoundTightening().propagate(model, bounds))
                 return false;
+            for (ExpressionId op : expr.operands) {
+                if (!bounds[op.var()].isFinite())
+                    return false;
+            }
+            continue;
+        }
+        case UMO_OP_FLOOR:
+        case UMO_OP_CEIL:
+            continue;
+        case UMO_OP_IDIV:
+        case UMO_OP_MOD:
+        case UMO_OP_ROUND:
+        case UMO_OP_SIGN: {
+            if (expr.op == UMO_OP_IDIV || expr.op == UMO_OP_MOD) {
+                ExpressionId d = expr.operands[1];
+                if (!model.isConstant(d.var()) ||
+                    model.getExpressionIdValue(d) == 0.0)
+                    return false;
             }
+            if (indicators)
+                continue;
+            // The sign of the operand is decided with big-M rows
+            if (bounds.empty() && !BoundTightening().propagate(model, bounds))
+                return false;
+            ExpressionId op = expr.operands[0];
+            Interval b = op.isMinus() ? -bounds[op.var()] : bounds[op.var()];
+            if (!b.isFinite() && b.lb < 0.0 && b.ub >= 0.0)
+                return false;
             continue;
+        }
         case UMO_OP_LINEARCOMP:
             if (!model.isConstraintPos(i) || model.isConstraintNeg(i)) {
                 return false;
             }
             continue;
-        default:
-            return false;
+        default: {
+            if (quadratic && isQuadraticTerm(model, i))
+                continue;
+            if (!usePiecewise(model) || !isPiecewiseLinearizable(model, i))
+                return false;
+            if (bounds.empty() && !BoundTightening().propagate(model, bounds))
+                return false;
+            ExpressionId op;
+            for (ExpressionId id : expr.operands) {
+                if (!model.isConstant(id.var()))
+                    op = id;
+            }
+            Interval domain =
+                op.isMinus() ? -bounds[op.var()] : bounds[op.var()];
+            bool integer = model.expression(op.var()).type != UMO_TYPE_FLOAT;
+            vector<double> points;
+            vector<double> values;
+            if (!computeBreakpoints(
+                    model, i, domain, integer,
+                    model.getFloatParameter("piecewise_tolerance"), points,
+                    values))
+                return false;
+            continue;
+        }
         }
     }
     return true;
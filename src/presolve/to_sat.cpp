@@ -1,9 +1,12 @@
 
 #include "presolve/to_sat.hpp"
 #include "model/operator.hpp"
+#include "presolve/incremental.hpp"
 #include "utils/utils.hpp"
 
 #include <cassert>
+#include <memory>
+#include <mutex>
 
 using namespace std;
 
@@ -15,6 +18,11 @@ class ToSat::Transformer {
     Transformer(PresolvedModel &);
     void run();
 
+    // Reuse the previous transformation if the model only grew since
+    bool restore();
+    // Keep the transformation for the next solve and apply it to the model
+    void save();
+
     void createExpressions();
     void satify(uint32_t i);
 
@@ -45,16 +53,73 @@ class ToSat::Transformer {
 
     ExpressionId constantZero;
     ExpressionId constantOne;
+
+    // State kept between solves, or null if not incremental
+    shared_ptr<IncrementalState> state;
+    // First expression not handled by the previous transformation
+    uint32_t first;
+    // Previous expressions that became constraints since
+    vector<uint32_t> newConstraints;
 };
 
-ToSat::Transformer::Transformer(PresolvedModel &model) : model(model) {
+// Last transformation of a model
+struct SatSnapshot {
+    PresolvedModel input;
+    PresolvedModel output;
+};
+
+ToSat::Transformer::Transformer(PresolvedModel &model)
+    : model(model), state(incrementalStateOf(model)), first(0) {
     constantZero = satModel.createConstant(0.0);
     constantOne = satModel.createConstant(1.0);
 }
 
+bool ToSat::Transformer::restore() {
+    if (!state)
+        return false;
+    shared_ptr<SatSnapshot> snapshot;
+    {
+        // The snapshot is taken over, and replaced after the transformation
+        lock_guard<mutex> lock(state->mutex);
+        snapshot = move(state->sat);
+    }
+    if (!snapshot || !model.extends(snapshot->input))
+        return false;
+    const PresolvedModel &prev = snapshot->input;
+    vector<uint32_t> constrained;
+    for (uint32_t i = 0; i < prev.nbExpressions(); ++i) {
+        if (model.isConstraintPos(i) == prev.isConstraintPos(i) &&
+            model.isConstraintNeg(i) == prev.isConstraintNeg(i))
+            continue;
+        // Previous constraints have no variable to enforce
+        if (prev.isConstraint(i) || model.isConstant(i))
+            return false;
+        constrained.push_back(i);
+    }
+    satModel = move(snapshot->output);
+    first = prev.nbExpressions();
+    newConstraints = constrained;
+    lock_guard<mutex> lock(state->mutex);
+    ++state->nbSatReused;
+    return true;
+}
+
+void ToSat::Transformer::save() {
+    if (!state) {
+        model.apply(satModel);
+        return;
+    }
+    shared_ptr<SatSnapshot> next = make_shared<SatSnapshot>();
+    next->input = model;
+    next->output = move(satModel);
+    model.apply(next->output);
+    lock_guard<mutex> lock(state->mutex);
+    state->sat = move(next);
+}
+
 void ToSat::Transformer::createExpressions() {
     // Copy expressions
-    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+    for (uint32_t i = first; i < model.nbExpressions(); ++i) {
         const auto &expr = model.expression(i);
         if (expr.op == UMO_OP_INVALID)
             continue;
@@ -65,7 +130,7 @@ void ToSat::Transformer::createExpressions() {
                 throw runtime_error("Only boolean expressions are supported");
             }
             ExpressionId newId = satModel.createExpression(UMO_OP_DEC_BOOL, {});
-            satModel.mapping().emplace(i, newId);
+            satModel.setMapping(i, newId);
         } else {
             if (expr.type != UMO_TYPE_BOOL) {
                 throw runtime_error("Only boolean expressions are supported");
@@ -75,7 +140,7 @@ void ToSat::Transformer::createExpressions() {
                 continue;
             }
             ExpressionId newId = satModel.createExpression(UMO_OP_DEC_BOOL, {});
-            satModel.mapping().emplace(i, newId);
+            satModel.setMapping(i, newId);
         }
     }
 }
@@ -280,7 +345,7 @@ ExpressionId ToSat::Transformer::getMapping(ExpressionId id, bool useOriginalId)
             return satModel.createConstant(model.getExpressionIdValue(id));
         }
         else {
-            pid = satModel.mapping().at(id.var());
+            pid = satModel.getMapping(id.var());
         }
         return id.isNot() ? pid.getNot() : pid;
     }
@@ -290,11 +355,18 @@ ExpressionId ToSat::Transformer::getMapping(ExpressionId id, bool useOriginalId)
 }
 
 void ToSat::Transformer::run() {
+    restore();
     createExpressions();
-    for (uint32_t i = 0; i < model.nbExpressions(); ++i) {
+    for (uint32_t i : newConstraints) {
+        if (model.isConstraintPos(i))
+            constrainPos(i);
+        if (model.isConstraintNeg(i))
+            constrainNeg(i);
+    }
+    for (uint32_t i = first; i < model.nbExpressions(); ++i) {
         satify(i);
     }
-    model.apply(satModel);
+    save();
 }
 
 bool ToSat::valid(const PresolvedModel &model) const {
@@ -41,12 +41,26 @@ class OTmpFile : public ofstream {
     std::string filename_;
 };
 
+namespace {
+// CBC and GLPK read neither indicator constraints nor quadratic terms; only
+// applied to the model being linearized, as valid() must not modify it
+void disableUnsupported(PresolvedModel &m) {
+    m.setStringParameter("indicator_constraints", "off");
+    m.setStringParameter("linearization_target", "linear");
+}
+} // namespace
+
 bool CbcSolver::valid(PresolvedModel &m) const {
-    return presolve::ToLinear().valid(m);
+    return presolve::ToLinear().valid(m, true);
 }
 
 void CbcSolver::run(PresolvedModel &m) const {
-    presolve::ToLinear().run(m);
+    disableUnsupported(m);
+    presolve::linearize(m);
+    if (m.infeasible()) {
+        m.setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string tmpName = temporaryFilename("umo-cbc-", "");
     string tmpModName = tmpName + "-mod.lp";
     string tmpSolName = tmpName + "-out.sol";
@@ -81,7 +95,11 @@ bool CplexSolver::valid(PresolvedModel &m) const {
 }
 
 void CplexSolver::run(PresolvedModel &m) const {
-    presolve::ToLinear().run(m);
+    presolve::linearize(m);
+    if (m.infeasible()) {
+        m.setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string tmpName = temporaryFilename("umo-cplex-", "");
     string tmpModName = tmpName + "-mod.lp";
     string tmpSolName = tmpName + "-out.sol";
@@ -110,11 +128,16 @@ void CplexSolver::run(PresolvedModel &m) const {
 }
 
 bool GlpkSolver::valid(PresolvedModel &m) const {
-    return presolve::ToLinear().valid(m);
+    return presolve::ToLinear().valid(m, true);
 }
 
 void GlpkSolver::run(PresolvedModel &m) const {
-    presolve::ToLinear().run(m);
+    disableUnsupported(m);
+    presolve::linearize(m);
+    if (m.infeasible()) {
+        m.setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string tmpName = temporaryFilename("umo-glpk-", "");
     string tmpModName = tmpName + "-mod.lp";
     string tmpSolName = tmpName + "-out.sol";
@@ -149,7 +172,11 @@ bool GurobiSolver::valid(PresolvedModel &m) const {
 }
 
 void GurobiSolver::run(PresolvedModel &m) const {
-    presolve::ToLinear().run(m);
+    presolve::linearize(m);
+    if (m.infeasible()) {
+        m.setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string tmpName = temporaryFilename("umo-gurobi-", "");
     string tmpModName = tmpName + "-mod.lp";
     string tmpSolName = tmpName + "-out.sol";
@@ -180,7 +207,11 @@ bool ScipSolver::valid(PresolvedModel &m) const {
 }
 
 void ScipSolver::run(PresolvedModel &m) const {
-    presolve::ToLinear().run(m);
+    presolve::linearize(m);
+    if (m.infeasible()) {
+        m.setStatus(UMO_STATUS_INFEASIBLE);
+        return;
+    }
     string tmpName = temporaryFilename("umo-scip-", "");
     string tmpModName = tmpName + "-mod.lp";
     string tmpSolName = tmpName + "-out.sol";
@@ -4,6 +4,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "api/umo_enums.h"
+#include "model/model.hpp"
 #include "model/operator.hpp"
 
 #include <cmath>
@@ -17,3 +18,61 @@ BOOST_AUTO_TEST_CASE(Basic) {
     BOOST_CHECK(op.validOperands(2, operandTypes, operandOps));
     BOOST_CHECK(!op.validOperands(1, operandTypes, operandOps));
 }
+
+BOOST_AUTO_TEST_CASE(Bounds) {
+    Interval ops[2] = {Interval(-2.0, 3.0), Interval(1.0, 4.0)};
+    BOOST_CHECK(Operator::get(UMO_OP_SUM).computeBounds(2, ops) ==
+                Interval(-1.0, 7.0));
+    BOOST_CHECK(Operator::get(UMO_OP_PROD).computeBounds(2, ops) ==
+                Interval(-8.0, 12.0));
+    BOOST_CHECK(Operator::get(UMO_OP_MIN).computeBounds(2, ops) ==
+                Interval(-2.0, 3.0));
+    BOOST_CHECK(Operator::get(UMO_OP_MAX).computeBounds(2, ops) ==
+                Interval(1.0, 4.0));
+    BOOST_CHECK(Operator::get(UMO_OP_ABS).computeBounds(1, ops) ==
+                Interval(0.0, 3.0));
+    BOOST_CHECK(Operator::get(UMO_OP_SQUARE).computeBounds(1, ops) ==
+                Interval(0.0, 9.0));
+    BOOST_CHECK(Operator::get(UMO_OP_SIGN).computeBounds(1, ops + 1) ==
+                Interval(1.0));
+    BOOST_CHECK(Operator::get(UMO_OP_CMP_LEQ).computeBounds(2, ops) ==
+                Interval(0.0, 1.0));
+    Interval cmp[2] = {Interval(-2.0, 0.5), Interval(1.0, 4.0)};
+    BOOST_CHECK(Operator::get(UMO_OP_CMP_LT).computeBounds(2, cmp) ==
+                Interval(1.0));
+    BOOST_CHECK(Operator::get(UMO_OP_CMP_EQ).computeBounds(2, cmp) ==
+                Interval(0.0));
+    Interval angle(0.1, 0.2);
+    Interval cos = Operator::get(UMO_OP_COS).computeBounds(1, &angle);
+    BOOST_CHECK_CLOSE(cos.lb, std::cos(0.2), 1e-9);
+    BOOST_CHECK_CLOSE(cos.ub, std::cos(0.1), 1e-9);
+    Interval period(-1.0, 7.0);
+    BOOST_CHECK(Operator::get(UMO_OP_SIN).computeBounds(1, &period) ==
+                Interval(-1.0, 1.0));
+    Interval divs[2] = {Interval(-7.0, 9.0), Interval(-2.0, 3.0)};
+    BOOST_CHECK(Operator::get(UMO_OP_IDIV).computeBounds(2, divs) ==
+                Interval(-9.0, 9.0));
+    BOOST_CHECK(Operator::get(UMO_OP_MOD).computeBounds(2, divs) ==
+                Interval(-2.0, 2.0));
+}
+
+BOOST_AUTO_TEST_CASE(ModelBounds) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId five = model.createConstant(5.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, five});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y.getMinus()});
+    ExpressionId prod = model.createExpression(UMO_OP_PROD, {sum, b});
+    ExpressionId cmp = model.createExpression(UMO_OP_CMP_LEQ, {prod, ten});
+    BOOST_CHECK(model.getBounds(x) == Interval(0.0, 10.0));
+    BOOST_CHECK(model.getBounds(sum) == Interval(-5.0, 10.0));
+    BOOST_CHECK(model.getBounds(prod) == Interval(-5.0, 10.0));
+    BOOST_CHECK(model.getBounds(cmp) == Interval(1.0));
+    BOOST_CHECK(model.getBounds(b.getNot()) == Interval(0.0, 1.0));
+    // The cache is invalidated by new expressions
+    ExpressionId twice = model.createExpression(UMO_OP_SUM, {sum, sum});
+    BOOST_CHECK(model.getBounds(twice) == Interval(-10.0, 20.0));
+}
@@ -0,0 +1,1616 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PRESOLVE
+
+#include <boost/test/unit_test.hpp>
+
+#include "model/linear_matrix.hpp"
+#include "model/operator.hpp"
+#include "model/presolved_model.hpp"
+#include "presolve/boolean_propagation.hpp"
+#include "presolve/bound_tightening.hpp"
+#include "presolve/cache.hpp"
+#include "presolve/clique_merging.hpp"
+#include "presolve/dual_reductions.hpp"
+#include "presolve/equality_substitution.hpp"
+#include "presolve/equivalent_literals.hpp"
+#include "presolve/implied_integers.hpp"
+#include "presolve/incremental.hpp"
+#include "presolve/parallel_rows.hpp"
+#include "presolve/row_presolve.hpp"
+#include "presolve/symmetry_breaking.hpp"
+#include "presolve/to_linear.hpp"
+#include "presolve/to_sat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+using namespace umoi;
+using namespace umoi::presolve;
+using namespace std;
+
+namespace {
+Interval decisionBounds(const Model &model, ExpressionId id) {
+    const Model::ExpressionData &expr = model.expression(id.var());
+    return Interval(model.getExpressionIdValue(expr.operands[0]),
+                    model.getExpressionIdValue(expr.operands[1]));
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(BoundTighteningDecisions) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId four = model.createConstant(4.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y});
+    ExpressionId cmp = model.createExpression(UMO_OP_CMP_LEQ, {sum, four});
+    model.createConstraint(cmp);
+    PresolvedModel presolved(model);
+    BoundTightening().run(presolved);
+    presolved.check();
+    BOOST_CHECK(!presolved.infeasible());
+    ExpressionId newX = presolved.mapping().at(x.var());
+    ExpressionId newY = presolved.mapping().at(y.var());
+    BOOST_CHECK(decisionBounds(presolved, newX) == Interval(0.0, 4.0));
+    BOOST_CHECK(decisionBounds(presolved, newY) == Interval(0.0, 4.0));
+}
+
+BOOST_AUTO_TEST_CASE(BoundTighteningBackward) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // x - y >= 1 and b or (y >= 3)
+    ExpressionId diff = model.createExpression(UMO_OP_SUM, {x, y.getMinus()});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_GEQ, {diff, one}));
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId geq = model.createExpression(UMO_OP_CMP_GEQ, {y, three});
+    model.createConstraint(model.createExpression(UMO_OP_AND, {b.getNot(), geq}));
+    PresolvedModel presolved(model);
+    vector<Interval> bounds;
+    BOOST_CHECK(BoundTightening().propagate(presolved, bounds));
+    BOOST_CHECK(bounds[b.var()] == Interval(0.0));
+    BOOST_CHECK(bounds[y.var()] == Interval(3.0, 9.0));
+    BOOST_CHECK(bounds[x.var()] == Interval(4.0, 10.0));
+    BOOST_CHECK(bounds[diff.var()] == Interval(1.0, 7.0));
+}
+
+BOOST_AUTO_TEST_CASE(BoundTighteningInfeasible) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId x1 = model.createExpression(UMO_OP_SUM, {x, one});
+    ExpressionId y1 = model.createExpression(UMO_OP_SUM, {y, one});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {x1, y}));
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {y1, x}));
+    PresolvedModel presolved(model);
+    BoundTightening().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearInfeasibleBounds) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId x1 = model.createExpression(UMO_OP_SUM, {x, one});
+    ExpressionId y1 = model.createExpression(UMO_OP_SUM, {y, one});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {x1, y}));
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {y1, x}));
+    PresolvedModel presolved(model);
+    ToLinear().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+    PresolvedModel linearized(model);
+    linearize(linearized);
+    BOOST_CHECK(linearized.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearAuxiliaryBounds) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId five = model.createConstant(5.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, five});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, five});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y});
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    ToLinear().run(presolved);
+    presolved.check();
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = presolved.expression(i);
+        if (expr.op != UMO_OP_DEC_INT)
+            continue;
+        Interval bounds = decisionBounds(presolved, ExpressionId::fromVar(i));
+        BOOST_CHECK(bounds.isFinite());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearInlinedSum) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId z = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    // x - 2z + (x + y) <= 10 is a single row on the decisions
+    ExpressionId prod = model.createExpression(UMO_OP_PROD, {z, two});
+    ExpressionId inner = model.createExpression(UMO_OP_SUM, {x, y});
+    ExpressionId sum =
+        model.createExpression(UMO_OP_SUM, {x, prod.getMinus(), inner});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {sum, ten}));
+    model.createObjective(x, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    ToLinear().run(presolved);
+    presolved.check();
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 1);
+    uint32_t nbDecisions = 0;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        const Model::ExpressionData &expr = presolved.expression(i);
+        if (Operator::get(expr.op).isDecision())
+            ++nbDecisions;
+        if (expr.op != UMO_OP_LINEARCOMP)
+            continue;
+        // The two terms on x are merged
+        BOOST_CHECK_EQUAL(expr.operands.size(), 8);
+        BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(expr.operands[1]),
+                          10.0);
+    }
+    BOOST_CHECK_EQUAL(nbDecisions, 3);
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearLinearObjective) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId prod = model.createExpression(UMO_OP_PROD, {y, two});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, prod, three});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {x, y}));
+    model.createObjective(sum.getMinus(), UMO_OBJ_MINIMIZE);
+    PresolvedModel presolved(model);
+    ToLinear().run(presolved);
+    presolved.check();
+    // No auxiliary variable nor defining row for the objective
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 1);
+    ExpressionId obj = presolved.objective(0).first;
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(obj), UMO_OP_LINEAR);
+    BOOST_CHECK_EQUAL(presolved.objective(0).second, UMO_OBJ_MINIMIZE);
+    vector<ExpressionId> operands = presolved.getExpressionIdOperands(obj);
+    BOOST_CHECK_EQUAL(operands.size(), 6);
+    presolved.setFloatValue(presolved.mapping()[x.var()], 1.0);
+    presolved.setFloatValue(presolved.mapping()[y.var()], 2.0);
+    BOOST_CHECK_CLOSE(presolved.getFloatValue(obj), -8.0, 1e-6);
+    stringstream ss;
+    presolved.writeLp(ss);
+    BOOST_CHECK(ss.str().find("Minimize\n\t- 1 x0 - 2 x1\n") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearBooleanProducts) {
+    Model model;
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(-3.0), model.createConstant(5.0)});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId p1 = model.createExpression(UMO_OP_PROD, {b, x});
+    ExpressionId p2 =
+        model.createExpression(UMO_OP_PROD, {b, c.getNot(), three});
+    model.createObjective(model.createExpression(UMO_OP_SUM, {p1, p2}),
+                          UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    BOOST_CHECK(ToLinear().valid(presolved));
+    ToLinear().run(presolved);
+    presolved.check();
+    vector<ExpressionId> mapped;
+    for (ExpressionId id : {x, b, c}) {
+        mapped.push_back(presolved.mapping()[id.var()]);
+    }
+    // Auxiliary variables for the products and the conjunction of b and !c
+    mapped.resize(5);
+    ExpressionId conj;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        ExpressionId id = ExpressionId::fromVar(i);
+        umo_operator op = presolved.expression(i).op;
+        if (op == UMO_OP_DEC_BOOL && id != mapped[1] && id != mapped[2])
+            conj = id;
+        if (op == UMO_OP_DEC_INT && id != mapped[0]) {
+            double ub = decisionBounds(presolved, id).ub;
+            mapped[ub == 5.0 ? 3 : 4] = id;
+        }
+    }
+    BOOST_CHECK(conj.valid() && mapped[3].valid() && mapped[4].valid());
+    // The rows are satisfied by the exact products only
+    for (int vb = 0; vb <= 1; ++vb) {
+        for (int vc = 0; vc <= 1; ++vc) {
+            for (int vx = -3; vx <= 5; ++vx) {
+                presolved.setFloatValue(mapped[0], vx);
+                presolved.setFloatValue(mapped[1], vb);
+                presolved.setFloatValue(mapped[2], vc);
+                presolved.setFloatValue(conj, vb && !vc);
+                presolved.setFloatValue(mapped[3], vb * vx);
+                presolved.setFloatValue(mapped[4], 3 * (vb && !vc));
+                BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_VALID);
+                if (vx < 5) {
+                    presolved.setFloatValue(mapped[3], vb * vx + 1);
+                    BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_INVALID);
+                    presolved.setFloatValue(mapped[3], vb * vx);
+                }
+                presolved.setFloatValue(conj, !(vb && !vc));
+                BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_INVALID);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearMinMaxAbs) {
+    Model model;
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(-3.0), model.createConstant(5.0)});
+    ExpressionId y = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(1.0), model.createConstant(4.0)});
+    ExpressionId m = model.createExpression(UMO_OP_MAX, {x, y});
+    ExpressionId a = model.createExpression(UMO_OP_ABS, {x});
+    // Minimizing a maximum only needs the convex side
+    Model convex = model;
+    convex.createObjective(m, UMO_OBJ_MINIMIZE);
+    PresolvedModel presolvedConvex(convex);
+    BOOST_CHECK(ToLinear().valid(presolvedConvex));
+    ToLinear().run(presolvedConvex);
+    presolvedConvex.check();
+    for (uint32_t i = 0; i < presolvedConvex.nbExpressions(); ++i) {
+        BOOST_CHECK(presolvedConvex.expression(i).op != UMO_OP_DEC_BOOL);
+    }
+    // Maximizing them requires the selectors
+    model.createObjective(model.createExpression(UMO_OP_SUM, {m, a}),
+                          UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    BOOST_CHECK(ToLinear().valid(presolved));
+    ToLinear().run(presolved);
+    presolved.check();
+    ExpressionId newX = presolved.mapping()[x.var()];
+    ExpressionId newY = presolved.mapping()[y.var()];
+    ExpressionId newM;
+    ExpressionId newA;
+    vector<ExpressionId> selectors;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        ExpressionId id = ExpressionId::fromVar(i);
+        umo_operator op = presolved.expression(i).op;
+        if (op == UMO_OP_DEC_BOOL)
+            selectors.push_back(id);
+        if (op == UMO_OP_DEC_INT && id != newX && id != newY) {
+            if (decisionBounds(presolved, id).lb == 1.0)
+                newM = id;
+            else
+                newA = id;
+        }
+    }
+    BOOST_CHECK(newM.valid() && newA.valid());
+    BOOST_REQUIRE_EQUAL(selectors.size(), 3);
+    // Whether some value of the selectors satisfies the rows
+    auto feasible = [&]() {
+        for (int s = 0; s < 8; ++s) {
+            for (int j = 0; j < 3; ++j) {
+                presolved.setFloatValue(selectors[j], (s >> j) & 1);
+            }
+            if (presolved.getStatus() == UMO_STATUS_VALID)
+                return true;
+        }
+        return false;
+    };
+    for (int vx = -3; vx <= 5; ++vx) {
+        for (int vy = 1; vy <= 4; ++vy) {
+            presolved.setFloatValue(newX, vx);
+            presolved.setFloatValue(newY, vy);
+            presolved.setFloatValue(newM, max(vx, vy));
+            presolved.setFloatValue(newA, abs(vx));
+            BOOST_CHECK(feasible());
+            presolved.setFloatValue(newM, max(vx, vy) + 1);
+            BOOST_CHECK(!feasible());
+            presolved.setFloatValue(newM, max(vx, vy));
+            presolved.setFloatValue(newA, abs(vx) + 1);
+            BOOST_CHECK(!feasible());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearReifiedComparisons) {
+    for (string param : {"off", "on"}) {
+        Model model;
+        model.setStringParameter("indicator_constraints", param);
+        ExpressionId two = model.createConstant(2.0);
+        ExpressionId x = model.createExpression(
+            UMO_OP_DEC_INT,
+            {model.createConstant(-3.0), model.createConstant(5.0)});
+        ExpressionId y = model.createExpression(
+            UMO_OP_DEC_INT,
+            {model.createConstant(0.0), model.createConstant(4.0)});
+        ExpressionId leq = model.createExpression(UMO_OP_CMP_LEQ, {x, y});
+        ExpressionId neq = model.createExpression(UMO_OP_CMP_NEQ, {x, y});
+        // Both values of the comparisons may help
+        model.createObjective(model.createExpression(UMO_OP_SUM, {leq, neq}),
+                              UMO_OBJ_MAXIMIZE);
+        model.createConstraint(model.createExpression(
+            UMO_OP_CMP_LEQ,
+            {model.createExpression(UMO_OP_SUM, {neq, leq}), two}));
+        PresolvedModel presolved(model);
+        BOOST_CHECK(ToLinear().valid(presolved));
+        // Bounded operands are valid for big-M rows as well, and the check
+        // leaves the parameters untouched
+        BOOST_CHECK(ToLinear().valid(presolved, true));
+        BOOST_CHECK_EQUAL(
+            presolved.getStringParameter("indicator_constraints"), param);
+        ToLinear().run(presolved);
+        presolved.check();
+        ExpressionId newX = presolved.mapping()[x.var()];
+        ExpressionId newY = presolved.mapping()[y.var()];
+        // The objective is written on the results of the comparisons
+        ExpressionId objId = presolved.objective(0).first;
+        const auto &obj = presolved.expression(objId.var());
+        BOOST_REQUIRE_EQUAL(obj.operands.size(), 4);
+        ExpressionId newLeq = obj.operands[1];
+        ExpressionId newNeq = obj.operands[3];
+        vector<ExpressionId> selectors;
+        for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+            ExpressionId id = ExpressionId::fromVar(i);
+            if (presolved.expression(i).op == UMO_OP_DEC_BOOL &&
+                id != newLeq && id != newNeq)
+                selectors.push_back(id);
+        }
+        BOOST_REQUIRE_EQUAL(selectors.size(), 2);
+        stringstream lp;
+        presolved.writeLp(lp);
+        BOOST_CHECK_EQUAL(lp.str().find("->") != string::npos, param == "on");
+        // Whether some value of the selectors satisfies the rows
+        auto feasible = [&]() {
+            for (int s = 0; s < 4; ++s) {
+                presolved.setFloatValue(selectors[0], s & 1);
+                presolved.setFloatValue(selectors[1], s >> 1);
+                if (presolved.getStatus() == UMO_STATUS_VALID)
+                    return true;
+            }
+            return false;
+        };
+        for (int vx = -3; vx <= 5; ++vx) {
+            for (int vy = 0; vy <= 4; ++vy) {
+                presolved.setFloatValue(newX, vx);
+                presolved.setFloatValue(newY, vy);
+                presolved.setFloatValue(newLeq, vx <= vy);
+                presolved.setFloatValue(newNeq, vx != vy);
+                BOOST_CHECK(feasible());
+                presolved.setFloatValue(newLeq, vx > vy);
+                BOOST_CHECK(!feasible());
+                presolved.setFloatValue(newLeq, vx <= vy);
+                presolved.setFloatValue(newNeq, vx == vy);
+                BOOST_CHECK(!feasible());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearIntegerRounding) {
+    Model model;
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(-7.0), model.createConstant(7.0)});
+    ExpressionId y = model.createExpression(
+        UMO_OP_DEC_FLOAT,
+        {model.createConstant(-3.0), model.createConstant(3.0)});
+    vector<ExpressionId> results = {
+        model.createExpression(UMO_OP_IDIV, {x, model.createConstant(3.0)}),
+        model.createExpression(UMO_OP_MOD, {x, model.createConstant(-3.0)}),
+        model.createExpression(UMO_OP_SIGN, {x}),
+        model.createExpression(UMO_OP_FLOOR, {y}),
+        model.createExpression(UMO_OP_CEIL, {y}),
+        model.createExpression(UMO_OP_ROUND, {y})};
+    model.createObjective(model.createExpression(UMO_OP_SUM, results),
+                          UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    BOOST_CHECK(ToLinear().valid(presolved));
+    ToLinear().run(presolved);
+    presolved.check();
+    ExpressionId newX = presolved.mapping()[x.var()];
+    ExpressionId newY = presolved.mapping()[y.var()];
+    // The objective is written on the results, in order
+    ExpressionId objId = presolved.objective(0).first;
+    const auto &obj = presolved.expression(objId.var());
+    BOOST_REQUIRE_EQUAL(obj.operands.size(), 2 * results.size());
+    vector<ExpressionId> newResults;
+    for (size_t j = 0; j < results.size(); ++j) {
+        newResults.push_back(obj.operands[2 * j + 1]);
+    }
+    // Signs of the operands, and quotient of the modulo
+    vector<ExpressionId> signs;
+    ExpressionId quotient;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        ExpressionId id = ExpressionId::fromVar(i);
+        umo_operator op = presolved.expression(i).op;
+        bool isResult = find(newResults.begin(), newResults.end(), id) !=
+                        newResults.end();
+        if (op == UMO_OP_DEC_BOOL)
+            signs.push_back(id);
+        if (op == UMO_OP_DEC_INT && id != newX && !isResult)
+            quotient = id;
+    }
+    BOOST_REQUIRE_EQUAL(signs.size(), 4);
+    BOOST_REQUIRE(quotient.valid());
+    // Whether some value of the auxiliary variables satisfies the rows
+    auto feasible = [&]() {
+        for (int q = -3; q <= 3; ++q) {
+            presolved.setFloatValue(quotient, q);
+            for (int s = 0; s < 16; ++s) {
+                for (int j = 0; j < 4; ++j) {
+                    presolved.setFloatValue(signs[j], (s >> j) & 1);
+                }
+                if (presolved.getStatus() == UMO_STATUS_VALID)
+                    return true;
+            }
+        }
+        return false;
+    };
+    for (int vx = -7; vx <= 7; ++vx) {
+        for (double vy : {-2.5, -1.3, 0.0, 0.5, 1.7, 2.5}) {
+            presolved.setFloatValue(newX, vx);
+            presolved.setFloatValue(newY, vy);
+            vector<double> values = {double(vx / 3),
+                                     double(vx % -3),
+                                     vx >= 0 ? 1.0 : -1.0,
+                                     floor(vy),
+                                     ceil(vy),
+                                     round(vy)};
+            for (size_t j = 0; j < values.size(); ++j) {
+                presolved.setFloatValue(newResults[j], values[j]);
+            }
+            BOOST_CHECK(feasible());
+            for (size_t j = 0; j < values.size(); ++j) {
+                presolved.setFloatValue(newResults[j], values[j] + 1.0);
+                BOOST_CHECK(!feasible());
+                presolved.setFloatValue(newResults[j], values[j]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearXorEncodings) {
+    for (string param : {"auto", "chain", "parity"}) {
+        Model model;
+        model.setStringParameter("xor_encoding", param);
+        vector<ExpressionId> decisions;
+        for (int j = 0; j < 4; ++j) {
+            decisions.push_back(model.createExpression(UMO_OP_DEC_BOOL, {}));
+        }
+        ExpressionId x = model.createExpression(
+            UMO_OP_XOR,
+            {decisions[0], decisions[1].getNot(), decisions[2], decisions[3]});
+        model.createObjective(x, UMO_OBJ_MAXIMIZE);
+        PresolvedModel presolved(model);
+        BOOST_CHECK(ToLinear().valid(presolved));
+        ToLinear().run(presolved);
+        presolved.check();
+        vector<ExpressionId> newDecisions;
+        for (ExpressionId id : decisions) {
+            newDecisions.push_back(presolved.mapping()[id.var()]);
+        }
+        ExpressionId objId = presolved.objective(0).first;
+        ExpressionId newX = presolved.expression(objId.var()).operands[1];
+        // Auxiliary variables of the encoding
+        vector<ExpressionId> aux;
+        for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+            ExpressionId id = ExpressionId::fromVar(i);
+            if (!presolved.isDecision(i) || id == newX ||
+                find(newDecisions.begin(), newDecisions.end(), id) !=
+                    newDecisions.end())
+                continue;
+            aux.push_back(id);
+        }
+        if (param == "chain") {
+            BOOST_CHECK_EQUAL(aux.size(), 4);
+        } else {
+            // A single integer in the parity encoding
+            BOOST_REQUIRE_EQUAL(aux.size(), 1);
+            BOOST_CHECK_EQUAL(presolved.expression(aux[0].var()).op,
+                              UMO_OP_DEC_INT);
+        }
+        // Whether some value of the auxiliary variables satisfies the rows
+        auto feasible = [&]() {
+            for (int v = 0; v < (1 << (2 * aux.size())); ++v) {
+                bool inDomain = true;
+                for (size_t j = 0; j < aux.size(); ++j) {
+                    int val = (v >> (2 * j)) & 3;
+                    if (presolved.expression(aux[j].var()).op ==
+                        UMO_OP_DEC_BOOL)
+                        inDomain = inDomain && val <= 1;
+                    else
+                        inDomain = inDomain &&
+                                   val <= decisionBounds(presolved, aux[j]).ub;
+                }
+                if (!inDomain)
+                    continue;
+                for (size_t j = 0; j < aux.size(); ++j) {
+                    presolved.setFloatValue(aux[j], (v >> (2 * j)) & 3);
+                }
+                if (presolved.getStatus() == UMO_STATUS_VALID)
+                    return true;
+            }
+            return false;
+        };
+        for (int v = 0; v < 16; ++v) {
+            int parity = 1;
+            for (int j = 0; j < 4; ++j) {
+                presolved.setFloatValue(newDecisions[j], (v >> j) & 1);
+                parity ^= (v >> j) & 1;
+            }
+            presolved.setFloatValue(newX, parity);
+            BOOST_CHECK(feasible());
+            presolved.setFloatValue(newX, !parity);
+            BOOST_CHECK(!feasible());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearPiecewiseExp) {
+    Model model;
+    model.setStringParameter("piecewise_linear", "on");
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_FLOAT,
+        {model.createConstant(0.0), model.createConstant(2.0)});
+    ExpressionId y = model.createExpression(UMO_OP_EXP, {x});
+    model.createObjective(y, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    BOOST_CHECK(ToLinear().valid(presolved));
+    ToLinear().run(presolved);
+    presolved.check();
+    ExpressionId newX = presolved.mapping()[x.var()];
+    ExpressionId objId = presolved.objective(0).first;
+    ExpressionId newY = presolved.expression(objId.var()).operands[1];
+    // Read the breakpoints from the rows on x and on y
+    vector<double> points;
+    vector<double> values;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        const auto &expr = presolved.expression(i);
+        if (expr.op != UMO_OP_LINEARCOMP)
+            continue;
+        bool onX = false;
+        bool onY = false;
+        for (size_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
+            onX |= expr.operands[2 * j + 1] == newX;
+            onY |= expr.operands[2 * j + 1] == newY;
+        }
+        if (!onX && !onY)
+            continue;
+        vector<double> &bp = onX ? points : values;
+        bp.push_back(presolved.getExpressionIdValue(expr.operands[0]));
+        for (size_t j = 2; 2 * j + 1 < expr.operands.size(); ++j) {
+            double delta = presolved.getExpressionIdValue(expr.operands[2 * j]);
+            bp.push_back(bp.back() - delta);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(points.size(), values.size());
+    BOOST_CHECK(points.size() > 2);
+    BOOST_CHECK_CLOSE(points.front(), 0.0, 1.0e-9);
+    BOOST_CHECK_CLOSE(points.back(), 2.0, 1.0e-9);
+    // The chords are within the tolerance of the function
+    for (size_t j = 0; j + 1 < points.size(); ++j) {
+        BOOST_CHECK_CLOSE(values[j], exp(points[j]), 1.0e-9);
+        for (int k = 0; k <= 10; ++k) {
+            double t = points[j] + (points[j + 1] - points[j]) * k / 10.0;
+            double chord = values[j] + (values[j + 1] - values[j]) * k / 10.0;
+            BOOST_CHECK(abs(chord - exp(t)) <= 1.0e-3);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearPiecewiseInteger) {
+    Model model;
+    model.setStringParameter("piecewise_linear", "on");
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(-3.0), model.createConstant(4.0)});
+    ExpressionId y = model.createExpression(UMO_OP_SQUARE, {x});
+    model.createObjective(y, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    BOOST_CHECK(ToLinear().valid(presolved));
+    ToLinear().run(presolved);
+    presolved.check();
+    ExpressionId newX = presolved.mapping()[x.var()];
+    ExpressionId objId = presolved.objective(0).first;
+    ExpressionId newY = presolved.expression(objId.var()).operands[1];
+    // Fill ratio of each segment, and ordering binaries
+    vector<ExpressionId> fills;
+    vector<ExpressionId> orders;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        umo_operator op = presolved.expression(i).op;
+        if (op == UMO_OP_DEC_FLOAT)
+            fills.push_back(ExpressionId::fromVar(i));
+        if (op == UMO_OP_DEC_BOOL)
+            orders.push_back(ExpressionId::fromVar(i));
+    }
+    // One segment between consecutive integers
+    BOOST_REQUIRE_EQUAL(fills.size(), 7);
+    BOOST_REQUIRE_EQUAL(orders.size(), 6);
+    for (int v = -3; v <= 4; ++v) {
+        int nbFull = v + 3;
+        presolved.setFloatValue(newX, v);
+        for (int j = 0; j < 7; ++j) {
+            presolved.setFloatValue(fills[j], j < nbFull);
+            if (j > 0)
+                presolved.setFloatValue(orders[j - 1], j < nbFull);
+        }
+        presolved.setFloatValue(newY, v * v);
+        BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_VALID);
+        presolved.setFloatValue(newY, v * v + 1);
+        BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_INVALID);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ToLinearQuadratic) {
+    Model model;
+    ExpressionId x = model.createExpression(
+        UMO_OP_DEC_FLOAT, {model.createConstant(-4.0), model.createConstant(4)});
+    ExpressionId y = model.createExpression(
+        UMO_OP_DEC_INT, {model.createConstant(0.0), model.createConstant(4.0)});
+    ExpressionId xy = model.createExpression(
+        UMO_OP_PROD, {x, model.createConstant(3.0), y});
+    model.createConstraint(model.createExpression(
+        UMO_OP_CMP_GEQ, {model.createExpression(UMO_OP_SUM, {xy, x}),
+                         model.createConstant(2.0)}));
+    model.createObjective(model.createExpression(UMO_OP_SQUARE, {x}),
+                          UMO_OBJ_MINIMIZE);
+    PresolvedModel linear(model);
+    BOOST_CHECK(!ToLinear().valid(linear));
+    PresolvedModel presolved(model);
+    presolved.setStringParameter("linearization_target", "quadratic");
+    BOOST_CHECK(ToLinear().valid(presolved));
+    // Checked as linear for the backends without quadratic support, and the
+    // parameters are left untouched
+    BOOST_CHECK(!ToLinear().valid(presolved, true));
+    BOOST_CHECK_EQUAL(presolved.getStringParameter("linearization_target"),
+                      "quadratic");
+    ToLinear().run(presolved);
+    presolved.check();
+    // No auxiliary variable for the products
+    uint32_t nbDecisions = 0;
+    uint32_t nbProducts = 0;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        umo_operator op = presolved.expression(i).op;
+        if (Operator::get(op).isDecision())
+            ++nbDecisions;
+        if (op == UMO_OP_PROD)
+            ++nbProducts;
+    }
+    BOOST_CHECK_EQUAL(nbDecisions, 2);
+    BOOST_CHECK_EQUAL(nbProducts, 2);
+    ExpressionId newX = presolved.mapping()[x.var()];
+    ExpressionId newY = presolved.mapping()[y.var()];
+    presolved.setFloatValue(newX, 1.0);
+    presolved.setFloatValue(newY, 1.0);
+    BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_VALID);
+    presolved.setFloatValue(newX, 0.25);
+    BOOST_CHECK_EQUAL(presolved.getStatus(), UMO_STATUS_INVALID);
+    // Quadratic sections of the LP file, halved in the objective
+    stringstream ss;
+    presolved.writeLp(ss);
+    BOOST_CHECK(ss.str().find("[ 2 x0 ^ 2 ] / 2") != string::npos);
+    BOOST_CHECK(ss.str().find("x0 * x1 ]") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LinearMatrixForm) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, three});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {one, three});
+    // x + 2 y - x + 2 <= 3, with a duplicate and a constant term
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, three, one, x, two, y, one.getMinus(), x,
+                            one, two}));
+    // 1 <= 3 x + !b = 3 x - b + 1 <= 2
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {one, two, three, x, one, b.getNot()}));
+    ExpressionId obj = model.createExpression(
+        UMO_OP_LINEAR, {two, x, one, b, three, one});
+    model.createObjective(obj.getMinus(), UMO_OBJ_MAXIMIZE);
+    LinearMatrix matrix(model);
+    BOOST_REQUIRE_EQUAL(matrix.nbColumns(), 3);
+    BOOST_REQUIRE_EQUAL(matrix.nbRows(), 2);
+    BOOST_REQUIRE_EQUAL(matrix.nbNonZeros(), 3);
+    BOOST_CHECK_EQUAL(matrix.colExpr(1), b.var());
+    BOOST_CHECK_EQUAL(matrix.exprToCol(y.var()), 2);
+    BOOST_CHECK_EQUAL(matrix.exprToCol(zero.var()), LinearMatrix::InvalidIndex);
+    BOOST_CHECK_EQUAL(matrix.colType(1), UMO_TYPE_BOOL);
+    BOOST_CHECK_EQUAL(matrix.colType(2), UMO_TYPE_INT);
+    BOOST_CHECK_EQUAL(matrix.colLb(2), 1.0);
+    BOOST_CHECK_EQUAL(matrix.colUb(0), 3.0);
+    // Compressed rows: 2 y <= 1, then 0 <= 3 x - b <= 1
+    BOOST_CHECK_EQUAL(matrix.rowLb(0), -INFINITY);
+    BOOST_CHECK_EQUAL(matrix.rowUb(0), 1.0);
+    BOOST_CHECK_EQUAL(matrix.rowLb(1), 0.0);
+    BOOST_CHECK_EQUAL(matrix.rowUb(1), 1.0);
+    BOOST_CHECK(matrix.rowStart() == vector<uint32_t>({0, 1, 3}));
+    BOOST_CHECK(matrix.rowIndex() == vector<uint32_t>({2, 0, 1}));
+    BOOST_CHECK(matrix.rowValue() == vector<double>({2.0, 3.0, -1.0}));
+    // Compressed columns hold the same entries
+    BOOST_CHECK(matrix.colStart() == vector<uint32_t>({0, 1, 2, 3}));
+    BOOST_CHECK(matrix.colIndex() == vector<uint32_t>({1, 1, 0}));
+    BOOST_CHECK(matrix.colValue() == vector<double>({3.0, -1.0, 2.0}));
+    BOOST_CHECK_EQUAL(matrix.rowIndicator(0), LinearMatrix::InvalidIndex);
+    // The negation of the objective is applied to its coefficients
+    BOOST_REQUIRE_EQUAL(matrix.objectives().size(), 1);
+    const LinearMatrix::Objective &o = matrix.objectives()[0];
+    BOOST_CHECK(o.linear && o.maximize);
+    BOOST_CHECK(o.coefs == vector<double>({-2.0, -1.0, 0.0}));
+    BOOST_CHECK_EQUAL(o.offset, -3.0);
+}
+
+BOOST_AUTO_TEST_CASE(ToSatUnmappedOperand) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId ab = model.createExpression(UMO_OP_AND, {a, b});
+    model.createConstraint(ab);
+    model.createConstraint(model.createExpression(UMO_OP_OR, {ab, c}));
+    PresolvedModel presolved(model);
+    // The constrained AND has no expression in the SAT model
+    BOOST_CHECK_THROW(ToSat().run(presolved), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(EqualitySubstitutionDoubleton) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId five = model.createConstant(5.0);
+    ExpressionId six = model.createConstant(6.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId z = model.createExpression(UMO_OP_DEC_INT, {zero, five});
+    // 2x - y == 0 and x + y + z <= 6
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, two, x, one.getMinus(), y}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, six, one, x, one, y, one, z}));
+    model.createObjective(z, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    EqualitySubstitution().run(presolved);
+    presolved.check();
+    BOOST_CHECK(!presolved.infeasible());
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 1);
+    ExpressionId newX = presolved.mapping().at(x.var());
+    ExpressionId newY = presolved.mapping().at(y.var());
+    ExpressionId newZ = presolved.mapping().at(z.var());
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(newX), UMO_OP_LINEAR);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(newY), UMO_OP_DEC_FLOAT);
+    // The eliminated value is recovered
+    presolved.setFloatValue(newY, 2.0);
+    presolved.setFloatValue(newZ, 3.0);
+    presolved.push(model);
+    BOOST_CHECK_CLOSE(model.getFloatValue(x), 1.0, 1e-6);
+    BOOST_CHECK_CLOSE(model.getFloatValue(y), 2.0, 1e-6);
+    BOOST_CHECK_CLOSE(model.getFloatValue(z), 3.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(EqualitySubstitutionLinearized) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId prod = model.createExpression(UMO_OP_PROD, {y, three});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, prod});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {sum, ten}));
+    model.createObjective(x, UMO_OBJ_MAXIMIZE);
+    PresolvedModel linearized(model);
+    ToLinear().run(linearized);
+    PresolvedModel presolved(model);
+    linearize(presolved);
+    presolved.check();
+    BOOST_CHECK(presolved.nbConstraints() <= linearized.nbConstraints());
+    // At most the original decisions are left; y is fixed by dual reductions
+    uint32_t nbDecisions = 0;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        if (Operator::get(presolved.expression(i).op).isDecision())
+            ++nbDecisions;
+    }
+    BOOST_CHECK(nbDecisions <= 2);
+}
+
+BOOST_AUTO_TEST_CASE(EqualitySubstitutionInfeasible) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, one});
+    model.createConstraint(
+        model.createExpression(UMO_OP_LINEARCOMP, {three, three, one, x}));
+    PresolvedModel presolved(model);
+    EqualitySubstitution().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(RowPresolveBounds) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId five = model.createConstant(5.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, one});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, one});
+    // x + y <= 5 is redundant, 2y <= 1 is a bound
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, five, one, x, one, y}));
+    model.createConstraint(
+        model.createExpression(UMO_OP_LINEARCOMP, {minf, one, two, y}));
+    PresolvedModel presolved(model);
+    RowPresolve().run(presolved);
+    presolved.check();
+    BOOST_CHECK(!presolved.infeasible());
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 0);
+    ExpressionId newY = presolved.mapping().at(y.var());
+    BOOST_CHECK(decisionBounds(presolved, newY) == Interval(0.0, 0.5));
+}
+
+BOOST_AUTO_TEST_CASE(RowPresolveForcing) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId six = model.createConstant(6.0);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, three});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, three});
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {six, pinf, one, x, one, y}));
+    PresolvedModel presolved(model);
+    RowPresolve().run(presolved);
+    presolved.check();
+    BOOST_CHECK(!presolved.infeasible());
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 0);
+    presolved.push(model);
+    BOOST_CHECK_EQUAL(model.getFloatValue(x), 3.0);
+    BOOST_CHECK_EQUAL(model.getFloatValue(y), 3.0);
+}
+
+BOOST_AUTO_TEST_CASE(RowPresolveInfeasible) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId seven = model.createConstant(7.0);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, three});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, three});
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {seven, pinf, one, x, one, y}));
+    PresolvedModel presolved(model);
+    RowPresolve().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(RowPresolveCoefficients) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId bigM = model.createConstant(-20.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // x <= 20 b is tightened to x <= 10 b
+    ExpressionId c = model.createExpression(UMO_OP_LINEARCOMP,
+                                            {minf, zero, one, x, bigM, b});
+    model.createConstraint(c);
+    PresolvedModel presolved(model);
+    RowPresolve().run(presolved);
+    presolved.check();
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 1);
+    ExpressionId newC = *presolved.constraints().begin();
+    const Model::ExpressionData &expr = presolved.expression(newC.var());
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(expr.operands[1]), 0.0);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(expr.operands[2]), 1.0);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(expr.operands[4]), -10.0);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelRowsMerge) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId half = model.createConstant(0.5);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId four = model.createConstant(4.0);
+    ExpressionId six = model.createConstant(6.0);
+    ExpressionId eight = model.createConstant(8.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    // 2x + 4y <= 8, 0.5x + y >= 1 and x + 2y <= 6
+    ExpressionId c = model.createExpression(UMO_OP_LINEARCOMP,
+                                            {minf, eight, two, x, four, y});
+    model.createConstraint(c);
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {one, pinf, one, y, half, x}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, six, one, x, two, y}));
+    PresolvedModel presolved(model);
+    ParallelRows().run(presolved);
+    presolved.check();
+    BOOST_CHECK(!presolved.infeasible());
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), 1);
+    ExpressionId newC = *presolved.constraints().begin();
+    const Model::ExpressionData &expr = presolved.expression(newC.var());
+    // 2 <= x + 2y <= 4, whatever the scale of the row kept
+    ExpressionId newX = presolved.mapping().at(x.var());
+    double coefX = 0.0;
+    for (size_t j = 1; 2 * j + 1 < expr.operands.size(); ++j) {
+        if (expr.operands[2 * j + 1] == newX)
+            coefX = presolved.getExpressionIdValue(expr.operands[2 * j]);
+    }
+    double lb = presolved.getExpressionIdValue(expr.operands[0]) / coefX;
+    double ub = presolved.getExpressionIdValue(expr.operands[1]) / coefX;
+    BOOST_CHECK_CLOSE(lb, 2.0, 1e-6);
+    BOOST_CHECK_CLOSE(ub, 4.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelRowsInfeasible) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId four = model.createConstant(4.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, one, one, x, one, y}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {four, pinf, two, y, two, x}));
+    PresolvedModel presolved(model);
+    ParallelRows().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(BatchedValues) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y});
+    PresolvedModel presolved(model);
+    presolved.setFloatValues({x, y}, {2.0, 1.5});
+    presolved.push(model);
+    BOOST_CHECK_EQUAL(model.getFloatValue(x), 2.0);
+    BOOST_CHECK_EQUAL(model.getFloatValue(y), 1.5);
+    BOOST_CHECK_EQUAL(model.getFloatValue(sum), 3.5);
+    // Nothing is set if a value is invalid
+    BOOST_CHECK_THROW(model.setFloatValues({y, x}, {3.0, 0.5}), runtime_error);
+    BOOST_CHECK_EQUAL(model.getFloatValue(y), 1.5);
+    model.setFloatValues({x, y}, {4.0, 0.5});
+    presolved.pull(model);
+    vector<double> values = presolved.getFloatValues({x, y, sum});
+    BOOST_CHECK_EQUAL(values[0], 4.0);
+    BOOST_CHECK_EQUAL(values[1], 0.5);
+    BOOST_CHECK_EQUAL(values[2], 4.5);
+}
+
+BOOST_AUTO_TEST_CASE(DualFixing) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId five = model.createConstant(5.0);
+    ExpressionId eight = model.createConstant(8.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId w = model.createExpression(UMO_OP_DEC_FLOAT, {one, five});
+    ExpressionId o = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    // o >= x, x >= 2, x + w <= 8
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, pinf, one, o, mone, x}));
+    model.createConstraint(
+        model.createExpression(UMO_OP_LINEARCOMP, {two, pinf, one, x}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, eight, one, x, one, w}));
+    model.createObjective(o, UMO_OBJ_MINIMIZE);
+    PresolvedModel presolved(model);
+    DualReductions().run(presolved);
+    BOOST_CHECK(!presolved.infeasible());
+    // w is only limited from above: fixed to its lower bound
+    ExpressionId wId = presolved.mapping()[w.var()];
+    BOOST_CHECK(presolved.isConstant(wId.var()));
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(wId), 1.0);
+    BOOST_CHECK(!presolved.isConstant(presolved.mapping()[x.var()].var()));
+    BOOST_CHECK(!presolved.isConstant(presolved.mapping()[o.var()].var()));
+}
+
+BOOST_AUTO_TEST_CASE(DominatedColumns) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId mtwo = model.createConstant(-2.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, pinf});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, pinf});
+    ExpressionId o = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    // x + y >= 2, o >= x + 2y: x is always better than y
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {two, pinf, one, x, one, y}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, pinf, one, o, mone, x, mtwo, y}));
+    model.createObjective(o, UMO_OBJ_MINIMIZE);
+    PresolvedModel presolved(model);
+    DualReductions().run(presolved);
+    ExpressionId yId = presolved.mapping()[y.var()];
+    BOOST_CHECK(presolved.isConstant(yId.var()));
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(yId), 0.0);
+    BOOST_CHECK(!presolved.isConstant(presolved.mapping()[x.var()].var()));
+}
+
+BOOST_AUTO_TEST_CASE(FreeColumnSingleton) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId three = model.createConstant(3.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId hundred = model.createConstant(100.0);
+    ExpressionId pinf = model.createConstant(INFINITY);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_FLOAT, {zero, ten});
+    ExpressionId s = model.createExpression(UMO_OP_DEC_FLOAT, {zero, hundred});
+    // s = x + y, x + y >= 3
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, one, x, one, y, mone, s}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {three, pinf, one, x, one, y}));
+    model.createObjective(x, UMO_OBJ_MINIMIZE);
+    PresolvedModel presolved(model);
+    DualReductions().run(presolved);
+    BOOST_CHECK_EQUAL(presolved.constraints().size(), 1u);
+    BOOST_REQUIRE_EQUAL(presolved.postsolveStack().size(), 1u);
+    // The value of s is recovered from the removed row
+    presolved.setFloatValues({presolved.mapping()[x.var()],
+                              presolved.mapping()[y.var()]},
+                             {2.0, 4.0});
+    presolved.setStatus(UMO_STATUS_OPTIMAL);
+    presolved.push(model);
+    BOOST_CHECK_EQUAL(model.getFloatValue(s), 6.0);
+    BOOST_CHECK_EQUAL(model.getFloatValue(x), 2.0);
+    BOOST_CHECK_EQUAL(model.getFloatValue(y), 4.0);
+    // The status of the solver is kept through postsolve
+    BOOST_CHECK_EQUAL(model.getStatus(), UMO_STATUS_OPTIMAL);
+    presolved.setStatus(UMO_STATUS_INFEASIBLE);
+    presolved.push(model);
+    BOOST_CHECK_EQUAL(model.getStatus(), UMO_STATUS_INFEASIBLE);
+}
+
+namespace {
+Model hashModel(double ub, bool reverse) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId bound = model.createConstant(ub);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, bound});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, bound});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y});
+    ExpressionId c1 = model.createExpression(UMO_OP_CMP_LEQ, {sum, bound});
+    ExpressionId c2 = model.createExpression(UMO_OP_CMP_LEQ, {x, y});
+    model.createConstraint(reverse ? c2 : c1);
+    model.createConstraint(reverse ? c1 : c2);
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    return model;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(StructuralHash) {
+    Model model = hashModel(10.0, false);
+    // Independent of the order of the constraints and of the values
+    BOOST_CHECK_EQUAL(model.hash(), hashModel(10.0, true).hash());
+    model.setFloatValue(ExpressionId::fromVar(2), 3.0);
+    BOOST_CHECK_EQUAL(model.hash(), hashModel(10.0, false).hash());
+    BOOST_CHECK(model.hash() != hashModel(5.0, false).hash());
+    model.createObjective(ExpressionId::fromVar(2), UMO_OBJ_MINIMIZE);
+    BOOST_CHECK(model.hash() != hashModel(10.0, false).hash());
+}
+
+BOOST_AUTO_TEST_CASE(SaveLoad) {
+    Model model = hashModel(10.0, false);
+    PresolvedModel presolved = presolve::run(model);
+    linearize(presolved);
+    stringstream ss;
+    presolved.save(ss);
+    PresolvedModel loaded;
+    loaded.load(ss);
+    BOOST_CHECK_EQUAL(loaded.hash(), presolved.hash());
+    BOOST_CHECK(loaded.mapping() == presolved.mapping());
+    stringstream truncated(ss.str().substr(0, ss.str().size() / 2));
+    BOOST_CHECK_THROW(loaded.load(truncated), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(PresolveCache) {
+    Model model = hashModel(10.0, false);
+    PresolvedModel result;
+    BOOST_CHECK(!Cache(model, "presolve").find(result));
+    model.setStringParameter("presolve_cache", "on");
+    Cache cache(model, "presolve");
+    BOOST_CHECK(!cache.find(result));
+    cache.insert(presolve::run(model));
+    // Hit for an identical model, with its own parameters
+    Model other = hashModel(10.0, true);
+    other.setStringParameter("presolve_cache", "on");
+    other.setStringParameter("solver", "cbc");
+    BOOST_CHECK(Cache(other, "presolve").find(result));
+    BOOST_CHECK_EQUAL(result.getStringParameter("solver"), "cbc");
+    BOOST_CHECK(!Cache(other, "linearize").find(result));
+    // Entries saved on disk are found after the memory is cleared
+    model.setStringParameter("presolve_cache_dir", ".");
+    Cache diskCache(model, "presolve");
+    diskCache.insert(presolve::run(model));
+    Cache::clear();
+    BOOST_CHECK(!Cache(other, "presolve").find(result));
+    other.setStringParameter("presolve_cache_dir", ".");
+    BOOST_CHECK(Cache(other, "presolve").find(result));
+    BOOST_CHECK(result.mapping() == presolve::run(model).mapping());
+    remove(diskCache.filename().c_str());
+    Cache::clear();
+}
+
+BOOST_AUTO_TEST_CASE(PresolveCacheCollision) {
+    Model model = hashModel(10.0, false);
+    Model other = hashModel(5.0, false);
+    for (Model *m : {&model, &other}) {
+        m->setStringParameter("presolve_cache", "on");
+        m->setStringParameter("presolve_cache_dir", ".");
+    }
+    // Entry of another input stored under the key of the model
+    Cache cache(model, "presolve");
+    Cache otherCache(other, "presolve");
+    otherCache.insert(presolve::run(other));
+    rename(otherCache.filename().c_str(), cache.filename().c_str());
+    Cache::clear();
+    PresolvedModel result;
+    BOOST_CHECK(!cache.find(result));
+    remove(cache.filename().c_str());
+}
+
+BOOST_AUTO_TEST_CASE(PostsolveHash) {
+    Model model = hashModel(10.0, false);
+    PresolvedModel presolved(model);
+    PresolvedModel::PostsolveRecord record;
+    record.target = ExpressionId::fromVar(2);
+    record.coef = 1.0;
+    record.operands.push_back(ExpressionId::fromVar(3));
+    record.coefs.push_back(1.0);
+    record.lb = 0.0;
+    record.ub = 10.0;
+    PresolvedModel first = presolved;
+    first.addPostsolve(record);
+    // Records that postsolve differently have different hashes
+    record.ub = 5.0;
+    PresolvedModel second = presolved;
+    second.addPostsolve(record);
+    BOOST_CHECK(first.hash() != second.hash());
+    record.ub = 10.0;
+    record.coefs[0] = 2.0;
+    PresolvedModel third = presolved;
+    third.addPostsolve(record);
+    BOOST_CHECK(first.hash() != third.hash());
+}
+
+BOOST_AUTO_TEST_CASE(BooleanPropagationFixing) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId d = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId e = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId f = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // a & b, !a | c, c ^ d, !b | e | f
+    model.createConstraint(model.createExpression(UMO_OP_AND, {a, b}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {a.getNot(), c}));
+    model.createConstraint(model.createExpression(UMO_OP_XOR, {c, d}));
+    model.createConstraint(
+        model.createExpression(UMO_OP_OR, {b.getNot(), e, f}));
+    PresolvedModel presolved(model);
+    BooleanPropagation().run(presolved);
+    BOOST_CHECK(!presolved.infeasible());
+    vector<double> expected = {1.0, 1.0, 1.0, 0.0};
+    vector<ExpressionId> fixed = {a, b, c, d};
+    for (size_t i = 0; i < fixed.size(); ++i) {
+        ExpressionId id = presolved.mapping()[fixed[i].var()];
+        BOOST_CHECK(presolved.isConstant(id.var()));
+        BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(id), expected[i]);
+    }
+    // Only e | f is left
+    BOOST_REQUIRE_EQUAL(presolved.nbConstraints(), 1);
+    ExpressionId constraint = *presolved.constraints().begin();
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(constraint), UMO_OP_OR);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOperands(constraint).size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(BooleanPropagationConflict) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // a, a => b, b => c, !(b & c)
+    model.createConstraint(a);
+    model.createConstraint(model.createExpression(UMO_OP_OR, {a.getNot(), b}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {b.getNot(), c}));
+    model.createConstraint(model.createExpression(UMO_OP_AND, {b, c}).getNot());
+    PresolvedModel presolved(model);
+    BooleanPropagation().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(EquivalentLiteralsImplications) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId d = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // a <=> b, c <=> !a
+    model.createConstraint(model.createExpression(UMO_OP_OR, {a.getNot(), b}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {b.getNot(), a}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {a, c}));
+    model.createConstraint(
+        model.createExpression(UMO_OP_OR, {a.getNot(), c.getNot()}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {c, d}));
+    PresolvedModel presolved(model);
+    EquivalentLiterals().run(presolved);
+    BOOST_CHECK(!presolved.infeasible());
+    ExpressionId newA = presolved.mapping()[a.var()];
+    BOOST_CHECK(presolved.mapping()[b.var()] == newA);
+    BOOST_CHECK(presolved.mapping()[c.var()] == newA.getNot());
+    BOOST_CHECK(presolved.mapping()[d.var()] != newA);
+}
+
+BOOST_AUTO_TEST_CASE(EquivalentLiteralsGates) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId d = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // Same function built in structurally different ways
+    ExpressionId and1 = model.createExpression(UMO_OP_AND, {a, b});
+    ExpressionId nand =
+        model.createExpression(UMO_OP_OR, {b.getNot(), a.getNot()});
+    ExpressionId xor1 = model.createExpression(UMO_OP_XOR, {a, b});
+    ExpressionId xor2 = model.createExpression(
+        UMO_OP_OR, {model.createExpression(UMO_OP_AND, {a, b.getNot()}),
+                    model.createExpression(UMO_OP_AND, {a.getNot(), b})});
+    model.createConstraint(model.createExpression(UMO_OP_OR, {and1, c}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {nand, d}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {xor1, c}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {xor2, d}));
+    PresolvedModel presolved(model);
+    EquivalentLiterals().run(presolved);
+    BOOST_CHECK(!presolved.infeasible());
+    // The constraints only use the AND and the XOR
+    vector<uint32_t> used;
+    for (ExpressionId constraint : presolved.constraints()) {
+        for (ExpressionId op : presolved.getExpressionIdOperands(constraint)) {
+            if (!presolved.isDecision(op.var()))
+                used.push_back(op.var());
+        }
+    }
+    sort(used.begin(), used.end());
+    used.erase(unique(used.begin(), used.end()), used.end());
+    BOOST_REQUIRE_EQUAL(used.size(), 2u);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(ExpressionId::fromVar(used[0])),
+                      UMO_OP_AND);
+    BOOST_CHECK_EQUAL(presolved.getExpressionIdOp(ExpressionId::fromVar(used[1])),
+                      UMO_OP_XOR);
+}
+
+BOOST_AUTO_TEST_CASE(EquivalentLiteralsConflict) {
+    Model model;
+    ExpressionId a = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_EQ, {a, b}));
+    model.createConstraint(model.createExpression(UMO_OP_XOR, {a, b}));
+    PresolvedModel presolved(model);
+    EquivalentLiterals().run(presolved);
+    BOOST_CHECK(presolved.infeasible());
+}
+
+BOOST_AUTO_TEST_CASE(CliqueMergingPairs) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId minf = model.createConstant(-INFINITY);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId z = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId w = model.createExpression(UMO_OP_DEC_BOOL, {});
+    // x + y <= 1, x <= z, y <= z: clique over x, y and !z
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, one, one, x, one, y}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, zero, one, x, mone, z}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, zero, one, y, mone, z}));
+    // Not part of the clique
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {minf, one, one, x, one, w}));
+    PresolvedModel presolved(model);
+    CliqueMerging().run(presolved);
+    BOOST_CHECK(!presolved.infeasible());
+    BOOST_REQUIRE_EQUAL(presolved.nbConstraints(), 2);
+    bool found = false;
+    for (ExpressionId c : presolved.constraints()) {
+        vector<ExpressionId> ops = presolved.getExpressionIdOperands(c);
+        if (ops.size() != 8)
+            continue;
+        found = true;
+        // x + y - z <= 0
+        BOOST_CHECK_EQUAL(presolved.getExpressionIdValue(ops[1]), 0.0);
+        double sum = 0.0;
+        for (size_t j = 2; j < ops.size(); j += 2) {
+            sum += presolved.getExpressionIdValue(ops[j]);
+        }
+        BOOST_CHECK_EQUAL(sum, 1.0);
+    }
+    BOOST_CHECK(found);
+}
+
+BOOST_AUTO_TEST_CASE(ImpliedIntegersAuxiliaries) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId mtwo = model.createConstant(-2.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId a = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    // a - b = x, a + b = 2y: only one of a and b can be continuous
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, one, a, mone, b, mone, x}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, one, a, one, b, mtwo, y}));
+    // 2c = x is not implied integer
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, two, c, mone, x}));
+    PresolvedModel presolved(model);
+    // a, b and c are auxiliaries
+    presolved.mapping()[a.var()] = ExpressionId();
+    presolved.mapping()[b.var()] = ExpressionId();
+    presolved.mapping()[c.var()] = ExpressionId();
+    ImpliedIntegers().run(presolved);
+    int nbInt = 0;
+    int nbFloat = 0;
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        umo_operator op = presolved.expression(i).op;
+        nbInt += op == UMO_OP_DEC_INT;
+        nbFloat += op == UMO_OP_DEC_FLOAT;
+    }
+    BOOST_CHECK_EQUAL(nbInt, 4);
+    BOOST_CHECK_EQUAL(nbFloat, 1);
+    BOOST_CHECK_EQUAL(
+        presolved.getExpressionIdOp(presolved.mapping()[x.var()]),
+        UMO_OP_DEC_INT);
+}
+
+BOOST_AUTO_TEST_CASE(ImpliedIntegersSubstituted) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId one = model.createConstant(1.0);
+    ExpressionId mone = model.createConstant(-1.0);
+    ExpressionId mtwo = model.createConstant(-2.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId a = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    // x = a + b, a = 2b
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, one, x, mone, a, mone, b}));
+    model.createConstraint(model.createExpression(
+        UMO_OP_LINEARCOMP, {zero, zero, one, a, mtwo, b}));
+    model.createObjective(
+        model.createExpression(UMO_OP_LINEAR, {one, a, one, b}),
+        UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    // a and b are auxiliaries
+    presolved.mapping()[a.var()] = ExpressionId();
+    presolved.mapping()[b.var()] = ExpressionId();
+    EqualitySubstitution().run(presolved);
+    BOOST_REQUIRE_EQUAL(
+        presolved.getExpressionIdOp(presolved.mapping()[x.var()]),
+        UMO_OP_LINEAR);
+    // a would be implied integer, but x is computed from it
+    ImpliedIntegers().run(presolved);
+    presolved.check();
+    for (uint32_t i = 0; i < presolved.nbExpressions(); ++i) {
+        BOOST_CHECK(presolved.expression(i).op != UMO_OP_DEC_FLOAT);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SymmetryBreakingBooleans) {
+    Model model;
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId x1 = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId x2 = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId x3 = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x1, x2, x3});
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {sum, two}));
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    // The three decisions are interchangeable
+    vector<vector<uint32_t>> generators =
+        SymmetryBreaking().generators(presolved, 10.0);
+    BOOST_CHECK_EQUAL(generators.size(), 2);
+    for (const vector<uint32_t> &perm : generators) {
+        BOOST_CHECK_EQUAL(perm[two.var()], two.var());
+        BOOST_CHECK_EQUAL(perm[sum.var()], sum.var());
+    }
+    uint32_t nbConstraints = presolved.nbConstraints();
+    SymmetryBreaking().run(presolved);
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), nbConstraints);
+    presolved.setStringParameter("symmetry_breaking", "on");
+    SymmetryBreaking().run(presolved);
+    BOOST_CHECK_EQUAL(presolved.nbConstraints(), nbConstraints + 2);
+}
+
+BOOST_AUTO_TEST_CASE(SymmetryBreakingAsymmetric) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId two = model.createConstant(2.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x1 = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId x2 = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId prod = model.createExpression(UMO_OP_PROD, {x2, two});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x1, prod});
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    PresolvedModel presolved(model);
+    vector<vector<uint32_t>> generators =
+        SymmetryBreaking().generators(presolved, 10.0);
+    for (const vector<uint32_t> &perm : generators) {
+        BOOST_CHECK_EQUAL(perm[x1.var()], x1.var());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SymmetryBreakingTimeLimit) {
+    Model model;
+    vector<ExpressionId> xs;
+    for (int i = 0; i < 20; ++i)
+        xs.push_back(model.createExpression(UMO_OP_DEC_BOOL, {}));
+    model.createObjective(model.createExpression(UMO_OP_SUM, xs),
+                          UMO_OBJ_MAXIMIZE);
+    model.setStringParameter("symmetry_breaking", "on");
+    PresolvedModel complete(model);
+    SymmetryBreaking().run(complete);
+    BOOST_CHECK(!complete.timeLimited());
+    // Without any time, the search stops early and must not be cached
+    model.setFloatParameter("symmetry_time_limit", 0.0);
+    PresolvedModel limited(model);
+    SymmetryBreaking().run(limited);
+    BOOST_CHECK(limited.timeLimited());
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalLinearization) {
+    Model model;
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y});
+    model.createConstraint(
+        model.createExpression(UMO_OP_CMP_LEQ, {sum, model.createConstant(15.0)}));
+    ExpressionId gate = model.createExpression(UMO_OP_OR, {b, c});
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    // Nothing is kept unless the model is solved incrementally
+    PresolvedModel once(model);
+    ToLinear().run(once);
+    BOOST_CHECK(!model.incrementalState()->linear);
+    model.setStringParameter("incremental", "on");
+    PresolvedModel first(model);
+    ToLinear().run(first);
+    BOOST_CHECK(model.incrementalState()->linear);
+
+    // An unrelated model keeps its own state
+    Model unrelated;
+    unrelated.setStringParameter("incremental", "on");
+    PresolvedModel other(unrelated);
+    ToLinear().run(other);
+
+    // Append a constraint and enforce an existing gate
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {x, y}));
+    model.createConstraint(gate);
+    PresolvedModel incremental(model);
+    ToLinear().run(incremental);
+    BOOST_CHECK(incremental.extends(first));
+
+    // Same model transformed from scratch
+    PresolvedModel full(model);
+    full.setStringParameter("incremental", "off");
+    ToLinear().run(full);
+    BOOST_CHECK_EQUAL(incremental.nbConstraints(), full.nbConstraints() + 1);
+    BOOST_CHECK_EQUAL(incremental.mapping().size(), full.mapping().size());
+    for (ExpressionId id : {x, y, b}) {
+        BOOST_CHECK_EQUAL(incremental.getExpressionIdOp(
+                              incremental.mapping()[id.var()]),
+                          full.getExpressionIdOp(full.mapping()[id.var()]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalPresolve) {
+    Model model;
+    model.setStringParameter("incremental", "on");
+    ExpressionId zero = model.createConstant(0.0);
+    ExpressionId ten = model.createConstant(10.0);
+    ExpressionId x = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId y = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId z = model.createExpression(UMO_OP_DEC_INT, {zero, ten});
+    ExpressionId b = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId c = model.createExpression(UMO_OP_DEC_BOOL, {});
+    ExpressionId sum = model.createExpression(UMO_OP_SUM, {x, y, z});
+    ExpressionId fifteen = model.createConstant(15.0);
+    model.createConstraint(
+        model.createExpression(UMO_OP_CMP_LEQ, {sum, fifteen}));
+    model.createConstraint(model.createExpression(UMO_OP_OR, {b, c}));
+    model.createObjective(sum, UMO_OBJ_MAXIMIZE);
+    const presolve::IncrementalState &state = *model.incrementalState();
+    PresolvedModel first = presolve::run(model);
+    linearize(first);
+    BOOST_CHECK_EQUAL(state.nbLinearReused, 0u);
+
+    // A constraint that the presolve leaves apart is translated alone
+    model.createConstraint(model.createExpression(UMO_OP_CMP_LEQ, {x, y}));
+    PresolvedModel second = presolve::run(model);
+    linearize(second);
+    BOOST_CHECK_EQUAL(state.nbLinearReused, 1u);
+    // Same rows as a translation from scratch
+    PresolvedModel full = presolve::run(model);
+    full.setStringParameter("incremental", "off");
+    linearize(full);
+    stringstream secondLp;
+    stringstream fullLp;
+    second.writeLp(secondLp);
+    full.writeLp(fullLp);
+    BOOST_CHECK_EQUAL(secondLp.str(), fullLp.str());
+
+    // b and c become opposite literals: the earlier expressions are
+    // rewritten and the translation starts over
+    model.createConstraint(model.createExpression(
+        UMO_OP_OR, {b.getNot(), c.getNot()}));
+    PresolvedModel third = presolve::run(model);
+    linearize(third);
+    BOOST_CHECK_EQUAL(state.nbLinearReused, 1u);
+}
@@ -185,7 +185,9 @@ BOOST_AUTO_TEST_CASE(LinearizationFloatNeq1) {
     constraint(x != 2.0);
     maximize(x);
     model.setSolver(TOSTRING(SOLVER_PARAM));
-    BOOST_CHECK_THROW(model.solve(), std::runtime_error);
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 5.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
 }
 
 BOOST_AUTO_TEST_CASE(LinearizationFloatNeq2) {
@@ -204,7 +206,9 @@ BOOST_AUTO_TEST_CASE(LinearizationFloatNeq3) {
     constraint(!(x == 2.0));
     maximize(x);
     model.setSolver(TOSTRING(SOLVER_PARAM));
-    BOOST_CHECK_THROW(model.solve(), std::runtime_error);
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 5.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
 }
 
 BOOST_AUTO_TEST_CASE(LinearizationFloatNeq4) {
@@ -217,6 +221,43 @@ BOOST_AUTO_TEST_CASE(LinearizationFloatNeq4) {
     BOOST_CHECK_THROW(model.solve(), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(LinearizationIntNeq1) {
+    Model model;
+    IntExpression x = model.intVar(0, 5);
+    constraint(x != 0);
+    minimize(x);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 1.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationReified1) {
+    Model model;
+    IntExpression x = model.intVar(0, 10);
+    constraint(x >= 5);
+    constraint(x <= 3 || x >= 8);
+    minimize(x);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 8.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationReified2) {
+    Model model;
+    FloatExpression x = model.floatVar(0.0, 10.0);
+    FloatExpression y = model.floatVar(0.0, 10.0);
+    constraint(x + y <= 12.0);
+    constraint(x == 4.0 || y == 4.0);
+    maximize(x + 2.0 * y);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 4.0, eps);
+    BOOST_CHECK_CLOSE(y.getValue(), 8.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
 BOOST_AUTO_TEST_CASE(LinearizationAnd1) {
     Model model;
     BoolExpression dec1 = model.boolVar();
@@ -273,6 +314,25 @@ BOOST_AUTO_TEST_CASE(LinearizationOr2) {
     BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
 }
 
+BOOST_AUTO_TEST_CASE(LinearizationXor1) {
+    for (const char *encoding : {"chain", "parity"}) {
+        Model model;
+        model.setStringParam("xor_encoding", encoding);
+        std::vector<BoolExpression> vec;
+        for (int i = 0; i < 5; ++i) {
+            vec.push_back(model.boolVar());
+        }
+        constraint(logical_xor(vec));
+        constraint(vec[0] && vec[1]);
+        minimize(vec[2] || vec[3] || vec[4]);
+        model.setSolver(TOSTRING(SOLVER_PARAM));
+        model.solve();
+        BOOST_CHECK(vec[2].getValue() || vec[3].getValue() ||
+                    vec[4].getValue());
+        BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(LinearizationMax1) {
     Model model;
     FloatExpression dec1 = model.floatVar();
@@ -282,15 +342,133 @@ BOOST_AUTO_TEST_CASE(LinearizationMax1) {
     BOOST_CHECK_THROW(model.solve(), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(LinearizationMax2) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(0.0, 10.0);
+    FloatExpression dec2 = model.floatVar(0.0, 10.0);
+    constraint(dec1 + dec2 >= 4.0);
+    FloatExpression res = umo::max(dec1, dec2);
+    minimize(res);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(res.getValue(), 2.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationMax3) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(0.0, 10.0);
+    FloatExpression dec2 = model.floatVar(-5.0, 3.0);
+    maximize(umo::max(dec1, dec2));
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(dec1.getValue(), 10.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
 BOOST_AUTO_TEST_CASE(LinearizationMin1) {
     Model model;
     FloatExpression dec1 = model.floatVar();
     FloatExpression dec2 = model.floatVar();
+    // Only the one-sided rows are needed, and they leave the objective free
     maximize(umo::min(dec1, dec2));
     model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    if (TOSTRING(SOLVER_PARAM) == "glpk")
+        return; // Yes GLPK screws up the return value here
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Unbounded);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationMin2) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(0.0, 10.0);
+    FloatExpression dec2 = model.floatVar(0.0, 10.0);
+    constraint(dec1 + dec2 <= 4.0);
+    FloatExpression res = umo::min(dec1, dec2);
+    maximize(res);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(res.getValue(), 2.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationMin3) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(0.0, 10.0);
+    FloatExpression dec2 = model.floatVar(-5.0, 3.0);
+    minimize(umo::min(dec1, dec2));
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(dec2.getValue(), -5.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationMin4) {
+    Model model;
+    FloatExpression dec1 = model.floatVar();
+    FloatExpression dec2 = model.floatVar();
+    // The selectors need the bounds of the operands
+    minimize(umo::min(dec1, dec2));
+    model.setSolver(TOSTRING(SOLVER_PARAM));
     BOOST_CHECK_THROW(model.solve(), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(LinearizationAbs1) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(-7.0, 3.0);
+    maximize(umo::abs(dec1));
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(dec1.getValue(), -7.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationAbs2) {
+    Model model;
+    FloatExpression dec1 = model.floatVar(-7.0, 3.0);
+    constraint(dec1 <= -2.0);
+    minimize(umo::abs(dec1));
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(dec1.getValue(), -2.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationIdiv1) {
+    Model model;
+    IntExpression x = model.intVar(0, 100);
+    constraint(x / 7 <= 4);
+    maximize(x);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), 34.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationMod1) {
+    Model model;
+    IntExpression x = model.intVar(-100, 100);
+    constraint(x / 10 == -3);
+    constraint(x % 10 == -7);
+    maximize(x);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    BOOST_CHECK_CLOSE(x.getValue(), -37.0, eps);
+    BOOST_CHECK_EQUAL(model.getStatus(), Status::Optimal);
+}
+
+BOOST_AUTO_TEST_CASE(LinearizationPiecewise1) {
+    Model model;
+    model.setStringParam("piecewise_linear", "on");
+    FloatExpression x = model.floatVar(0.0, 4.0);
+    constraint(umo::sqrt(x) >= 1.5);
+    minimize(x);
+    model.setSolver(TOSTRING(SOLVER_PARAM));
+    model.solve();
+    // Within the tolerance of the approximation
+    BOOST_CHECK_SMALL(x.getValue() - 2.25, 0.01);
+}
+
 BOOST_AUTO_TEST_CASE(LinearizationMultiObjective) {
     Model model;
     FloatExpression dec1 = model.floatVar();